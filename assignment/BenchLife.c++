@@ -0,0 +1,303 @@
+// ---------------------------
+// projects/life/BenchLife.c++
+// ---------------------------
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // count_if
+#include <atomic>    // atomic
+#include <chrono>    // steady_clock
+#include <cstdint>   // uint32_t
+#include <cstdlib>   // atoi, atof, malloc, free
+#include <fstream>   // ofstream
+#include <iostream>  // cout
+#include <new>       // bad_alloc
+#include <sstream>   // istringstream
+#include <string>    // string
+
+#include "Life.h"
+
+// -----------
+// allocations
+// -----------
+
+/*
+Every allocation in the process goes through here, so a phase can report how
+many it made.
+*/
+
+namespace {
+std::atomic<unsigned long long> allocations(0);
+}
+
+// kept out of line, inlined next to a deallocate gcc mistakes free() here for a mismatch
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+using namespace std;
+
+// ------
+// boards
+// ------
+
+/*
+The boards are generated from a fixed seed so that every run, and every
+version, measures the same cells.
+*/
+
+struct Random {
+    uint32_t state;
+
+    explicit Random(uint32_t seed) : state(seed) {}
+
+    uint32_t operator()() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+};
+
+/**
+ * a board as text, the way the Life constructors read it
+ * @param h the height of the board
+ * @param w the width of the board
+ * @param density "soup" for random cells, "gliders" for a glider every 32x32
+ *        block, "still" for a block every 8x8 block
+ * @param alive the symbols of a live cell, picked at random
+ * @param dead the symbol of a dead cell
+ * @return the board, rows ended by '\n' and the board by a blank line
+ */
+string make_board(int h, int w, const string& density, const string& alive, char dead) {
+    string text(static_cast<size_t>(h) * (w + 1) + 1, dead);
+    Random random(371);
+
+    for (int x = 0; x < h; x++)
+        text[static_cast<size_t>(x) * (w + 1) + w] = '\n';
+    text[text.size() - 1] = '\n';
+
+    auto set = [&](int x, int y) {
+        if (x < h && y < w)
+            text[static_cast<size_t>(x) * (w + 1) + y] = alive[random() % alive.size()];
+    };
+
+    if (density == "soup") {
+        for (int x = 0; x < h; x++)
+            for (int y = 0; y < w; y++)
+                if (random() % 8 < 3)
+                    set(x, y);
+    }
+    else if (density == "gliders") {
+        for (int x = 0; x < h; x += 32)
+            for (int y = 0; y < w; y += 32) {
+                set(x, y + 1);
+                set(x + 1, y + 2);
+                set(x + 2, y);
+                set(x + 2, y + 1);
+                set(x + 2, y + 2);
+            }
+    }
+    else {
+        for (int x = 1; x < h; x += 8)
+            for (int y = 1; y < w; y += 8) {
+                set(x, y);
+                set(x, y + 1);
+                set(x + 1, y);
+                set(x + 1, y + 1);
+            }
+    }
+
+    return text;
+}
+
+// -------
+// measure
+// -------
+
+double min_seconds = 0.2;    // every measurement repeats until it has run this long
+
+volatile unsigned long long sink;    // results nobody reads, so the work is not optimized away
+
+/**
+ * print one result as a line of csv
+ */
+void report(const string& cell, int h, int w, const string& density, const string& phase,
+            unsigned long long repetitions, double seconds, unsigned long long allocated) {
+    const double cells = static_cast<double>(h) * w * repetitions;
+    cout << cell << ',' << h << 'x' << w << ',' << density << ',' << phase << ','
+         << repetitions << ',' << seconds << ',' << cells / seconds << ','
+         << static_cast<double>(allocated) / repetitions << '\n';
+}
+
+/**
+ * run f over and over until min_seconds have passed, at least once
+ * @param f the work, called with the repetition number
+ * @param seconds set to the time taken
+ * @param allocated set to the allocations made
+ * @return the number of repetitions
+ */
+template <class F>
+unsigned long long measure(F f, double& seconds, unsigned long long& allocated) {
+    typedef chrono::steady_clock clock;
+
+    const unsigned long long before = allocations;
+    const clock::time_point start = clock::now();
+    unsigned long long repetitions = 0;
+
+    do {
+        f(repetitions++);
+        seconds = chrono::duration<double>(clock::now() - start).count();
+    } while (seconds < min_seconds);
+
+    allocated = allocations - before;
+    return repetitions;
+}
+
+/**
+ * construct, evolve, print and iterate a board of one kind of cell
+ * @param cell the name of the cell, for the report
+ * @param text the board
+ */
+template <class T>
+void bench(const string& cell, int h, int w, const string& density, const string& text) {
+    double seconds;
+    unsigned long long allocated;
+    unsigned long long n;
+
+    n = measure([&](unsigned long long) {
+        Life<T> l(text.data(), text.data() + text.size());
+    }, seconds, allocated);
+    report(cell, h, w, density, "construct", n, seconds, allocated);
+
+    Life<T> l(text.data(), text.data() + text.size());
+
+    n = measure([&](unsigned long long) {
+        l.evolve_all();
+    }, seconds, allocated);
+    report(cell, h, w, density, "evolve", n, seconds, allocated);
+
+    ofstream null("/dev/null");
+    n = measure([&](unsigned long long) {
+        l.print(null);
+    }, seconds, allocated);
+    report(cell, h, w, density, "print", n, seconds, allocated);
+
+    unsigned long long live = 0;
+    n = measure([&](unsigned long long) {
+        live += count_if(l.begin(), l.end(), [](const T& c) { return c.is_alive(); });
+    }, seconds, allocated);
+    sink = live;
+    report(cell, h, w, density, "iterate", n, seconds, allocated);
+}
+
+/**
+ * count the live cells of an engine through at()
+ * @return the number of live cells
+ */
+template <class E>
+unsigned long long count_live(const E& l, int h, int w) {
+    unsigned long long live = 0;
+    for (int x = 0; x < h; x++)
+        for (int y = 0; y < w; y++)
+            if (l.at(x, y).is_alive())
+                live++;
+    return live;
+}
+
+/**
+ * the same through the iterators of a tiled board
+ * @return the number of live cells
+ */
+template <class T>
+unsigned long long count_live(const TiledLife<T>& l, int, int) {
+    return count_if(l.begin(), l.end(), [](const T& c) { return c.is_alive(); });
+}
+
+/**
+ * the same for the engines that only read from streams
+ * @param name the name of the engine, for the report
+ */
+template <class E>
+void bench_engine(const string& name, int h, int w, const string& density, const string& text) {
+    double seconds;
+    unsigned long long allocated;
+    unsigned long long n;
+
+    n = measure([&](unsigned long long) {
+        istringstream in(text);
+        E l(in, h, w);
+    }, seconds, allocated);
+    report(name, h, w, density, "construct", n, seconds, allocated);
+
+    istringstream in(text);
+    E l(in, h, w);
+
+    n = measure([&](unsigned long long) {
+        l.evolve_all();
+    }, seconds, allocated);
+    report(name, h, w, density, "evolve", n, seconds, allocated);
+
+    ofstream null("/dev/null");
+    n = measure([&](unsigned long long) {
+        l.print(null);
+    }, seconds, allocated);
+    report(name, h, w, density, "print", n, seconds, allocated);
+
+    unsigned long long live = 0;
+    n = measure([&](unsigned long long) {
+        live += count_live(l, h, w);
+    }, seconds, allocated);
+    sink = live;
+    report(name, h, w, density, "iterate", n, seconds, allocated);
+}
+
+}
+
+// ----
+// main
+// ----
+
+/*
+BenchLife [largest side [seconds per measurement]]
+
+Prints one csv line per cell type, board size, density and phase. Sizes go
+from 20x20 up, doubling from 32x32, to the largest side, 4096 by default.
+cells_per_second counts the cells of the board once per repetition,
+allocations is per repetition, so per generation for evolve.
+*/
+
+int main (int argc, char* argv[]) {
+    const int largest = argc > 1 ? atoi(argv[1]) : 4096;
+    if (argc > 2)
+        min_seconds = atof(argv[2]);
+
+    cout << "cell,size,density,phase,repetitions,seconds,cells_per_second,allocations\n";
+
+    const char* densities[] = {"soup", "gliders", "still"};
+
+    for (int side = 20; side <= largest; side = (side == 20) ? 32 : side * 2)
+        for (const char* density : densities) {
+            bench<ConwayCell>("ConwayCell", side, side, density, make_board(side, side, density, "*", '.'));
+            bench<FredkinCell>("FredkinCell", side, side, density, make_board(side, side, density, "0", '-'));
+            bench<Cell>("Cell", side, side, density, make_board(side, side, density, "*0", '.'));
+            bench<ConwayRuleCell>("ConwayRuleCell", side, side, density, make_board(side, side, density, "*", '.'));
+            bench<FredkinRuleCell>("FredkinRuleCell", side, side, density, make_board(side, side, density, "0", '-'));
+            bench_engine<ConwayLife>("ConwayLife", side, side, density, make_board(side, side, density, "*", '.'));
+            bench_engine<FredkinLife>("FredkinLife", side, side, density, make_board(side, side, density, "0", '-'));
+            bench_engine<MixedLife>("MixedLife", side, side, density, make_board(side, side, density, "*0", '.'));
+            bench_engine<TiledLife<ConwayCell> >("TiledConwayCell", side, side, density, make_board(side, side, density, "*", '.'));
+            cout.flush();
+        }
+
+    return 0;
+}
@@ -1,11 +1,68 @@
 #include <vector>
 #include <iostream>
 #include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <functional>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <atomic>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <unistd.h>
 
 #include "Life.h"
 
 using namespace std;
 
+#ifdef LIFE_STATS
+// -----
+// Stats
+// -----
+
+namespace {
+// per thread, so boards evolving on other threads at the same time do not count
+thread_local unsigned long long clones = 0;
+thread_local unsigned long long heap_clones = 0;
+
+/**
+ * count a cell being cloned
+ * @param heap was it cloned onto the heap?
+ */
+void count_clone(bool heap) {
+	clones++;
+	if (heap)
+		heap_clones++;
+}
+}
+
+unsigned long long cell_clones() {
+	return clones;
+}
+
+unsigned long long cell_allocations() {
+	return heap_clones;
+}
+#endif
+
 // ------------
 // AbstractCell
 // ------------
@@ -18,6 +75,10 @@ istream& operator>>(istream& in, AbstractCell& c) {
 	return in;
 }
 
+Cell AbstractCell::evolve(const Cell neighbors[8]) const {
+	return evolve(Neighborhood<Cell>(neighbors));
+}
+
 // ----------
 // ConwayCell
 // ----------
@@ -34,55 +95,49 @@ ConwayCell::ConwayCell(const char& input) {
 }
 
 ConwayCell operator+(const ConwayCell& old_cell, const ConwayCell neighbors[8]) {
+	return old_cell + Neighborhood<ConwayCell>(neighbors);
+}
+
+ConwayCell operator+(const ConwayCell& old_cell, const Neighborhood<ConwayCell>& neighbors) {
 	int live_neighbors = 0;
 
-	for (int i = 0; i < 8; i++)
-		if (!neighbors[i].border && neighbors[i].alive)
-			live_neighbors++;
+	for (int i = 0; i < ConwayRule::neighbors; i++)
+		live_neighbors += !neighbors[i].border && neighbors[i].alive;
 
-	if (old_cell.is_alive()) {
-		if (live_neighbors < 2 || live_neighbors > 3)
-			return ConwayCell('.');
-		else
-			return ConwayCell('*');
-	} else { // dead
-		if (live_neighbors == 3)
-			return ConwayCell('*');
-		else
-			return ConwayCell('.');
-	}
+	return ConwayCell(ConwayRule::next(old_cell.alive, live_neighbors) ? '*' : '.');
 }
 
 
 ConwayCell* ConwayCell::clone() const {
+#ifdef LIFE_STATS
+	count_clone(true);
+#endif
 	return new ConwayCell(*this);
 }
 
-Cell ConwayCell::evolve(const Cell neighbors[8]) const {
+ConwayCell* ConwayCell::clone(void* where) const {
+#ifdef LIFE_STATS
+	count_clone(false);
+#endif
+	return new (where) ConwayCell(*this);
+}
+
+bool ConwayCell::equals(const AbstractCell& rhs) const {
+	const ConwayCell* c = dynamic_cast<const ConwayCell*>(&rhs);
+	return c != nullptr && *this == *c;
+}
+
+Cell ConwayCell::evolve(const Neighborhood<Cell>& neighbors) const {
 	int live_neighbors = 0;
 
-	for (int i = 0; i < 8; i++) 
-		if (!neighbors[i].is_border() && neighbors[i].is_alive())
-			live_neighbors++;
+	for (int i = 0; i < ConwayRule::neighbors; i++)
+		live_neighbors += !neighbors[i].is_border() && neighbors[i].is_alive();
 
-	if (alive) {
-		if (live_neighbors < 2 || live_neighbors > 3)
-			return Cell(ConwayCell('.'));
-		else
-			return Cell(ConwayCell('*'));
-	} else { // dead
-		if (live_neighbors == 3)
-			return Cell(ConwayCell('*'));
-		else
-			return Cell(ConwayCell('.'));
-	}
+	return Cell(ConwayCell(ConwayRule::next(alive, live_neighbors) ? '*' : '.'));
 }
 
 ostream& ConwayCell::print(ostream& out) const {
-	if (alive)
-		return out << '*';
-	else
-		return out << '.';
+	return out << symbol();
 }
 
 // -----------
@@ -103,24 +158,18 @@ FredkinCell::FredkinCell(const char& input) : AbstractCell(false) {
 }
 
 FredkinCell operator+(const FredkinCell& old_cell, const FredkinCell neighbors[8]) {
+	return old_cell + Neighborhood<FredkinCell>(neighbors);
+}
+
+FredkinCell operator+(const FredkinCell& old_cell, const Neighborhood<FredkinCell>& neighbors) {
 	int live_neighbors = 0;
 
-	for (int i = 0; i < 4; i++)
-		if (!neighbors[i].border && neighbors[i].alive)
-			live_neighbors++;
+	for (int i = 0; i < FredkinRule::neighbors; i++)
+		live_neighbors += !neighbors[i].border && neighbors[i].alive;
 
-	if (old_cell.is_alive()) {
-		if (live_neighbors == 0 || live_neighbors == 2 || live_neighbors == 4)
-			return FredkinCell(old_cell.age(), false);
-		else {
-			return FredkinCell(old_cell.age() + 1, true);
-		}
-	} else { // dead
-		if (live_neighbors == 3 || live_neighbors == 1)
-			return FredkinCell(old_cell.age(), true);
-		else
-			return FredkinCell(old_cell.age(), false);
-	}
+	// a cell ages when it survives, and keeps its age when it is born or dies
+	const bool alive = FredkinRule::next(old_cell.alive, live_neighbors);
+	return FredkinCell(old_cell.age_ + (old_cell.alive && alive), alive);
 }
 
 FredkinCell::FredkinCell(int a, bool alive_) : AbstractCell(false) {
@@ -129,39 +178,36 @@ FredkinCell::FredkinCell(int a, bool alive_) : AbstractCell(false) {
 }
 
 FredkinCell* FredkinCell::clone() const {
+#ifdef LIFE_STATS
+	count_clone(true);
+#endif
 	return new FredkinCell(*this);
 }
 
-Cell FredkinCell::evolve(const Cell neighbors[8]) const {
+FredkinCell* FredkinCell::clone(void* where) const {
+#ifdef LIFE_STATS
+	count_clone(false);
+#endif
+	return new (where) FredkinCell(*this);
+}
+
+bool FredkinCell::equals(const AbstractCell& rhs) const {
+	const FredkinCell* c = dynamic_cast<const FredkinCell*>(&rhs);
+	return c != nullptr && *this == *c;
+}
+
+Cell FredkinCell::evolve(const Neighborhood<Cell>& neighbors) const {
 	int live_neighbors = 0;
 
-	for (int i = 0; i < 4; i++)
-		if (!neighbors[i].is_border() && neighbors[i].is_alive())
-			live_neighbors++;
+	for (int i = 0; i < FredkinRule::neighbors; i++)
+		live_neighbors += !neighbors[i].is_border() && neighbors[i].is_alive();
 
-	if (alive) {
-		if (live_neighbors == 0 || live_neighbors == 2 || live_neighbors == 4)
-			return Cell(FredkinCell(age_, false));
-		else {
-			return Cell(FredkinCell(age_ + 1, true));
-		}
-	} else { // dead
-		if (live_neighbors == 3 || live_neighbors == 1)
-			return Cell(FredkinCell(age_, true));
-		else
-			return Cell(FredkinCell(age_, false));
-	}
+	const bool next = FredkinRule::next(alive, live_neighbors);
+	return Cell(FredkinCell(age_ + (alive && next), next));
 }
 
 ostream& FredkinCell::print(ostream& out) const {
-	if (!alive)
-		return out << '-';
-	else {
-		if (age_ < 10) 
-			return out << age_;
-		else 
-			return out << '+';
-	}
+	return out << symbol();
 }
 
 const int FredkinCell::age() const {
@@ -175,25 +221,46 @@ const int FredkinCell::age() const {
 
 Cell::Cell(const char& c) {
 	if (c == '.' || c == '*')
-		this->acell = new ConwayCell(c);
+		this->acell = new (&storage) ConwayCell(c);
 	else
-		this->acell = new FredkinCell(c);
+		this->acell = new (&storage) FredkinCell(c);
 }
 
 Cell::Cell(const Cell& c) {
-	this->acell = c.acell->clone();
+	this->acell = c.acell ? c.acell->clone(&storage) : nullptr;
 }
 
 Cell::~Cell() {
-	delete acell;
+	release();
 }
 
 Cell& Cell::operator=(const Cell& rhs) {
-	acell = rhs.acell->clone();
+	if (this != &rhs) {
+		release();
+		acell = rhs.acell ? rhs.acell->clone(&storage) : nullptr;
+	}
 	return *this;
 }
 
+bool Cell::is_inline() const {
+	const char* p = reinterpret_cast<const char*>(acell);
+	const char* first = reinterpret_cast<const char*>(&storage);
+	return !less<const char*>()(p, first) && less<const char*>()(p, first + sizeof(storage));
+}
+
+void Cell::release() {
+	if (is_inline())
+		acell->~AbstractCell();
+	else
+		delete acell;
+	acell = nullptr;
+}
+
 Cell operator+(const Cell& old_cell, const Cell neighbors[8]) {
+	return old_cell + Neighborhood<Cell>(neighbors);
+}
+
+Cell operator+(const Cell& old_cell, const Neighborhood<Cell>& neighbors) {
 	Cell new_cell = old_cell.acell->evolve(neighbors);
 
 	// If Life is instantiated with Cell, then when a FredkinCell's age is to become 2, and only then, it becomes a live ConwayCell instead.
@@ -205,7 +272,17 @@ Cell operator+(const Cell& old_cell, const Cell neighbors[8]) {
 	return new_cell;
 }
 
-ostream& operator<<(ostream& out, const Cell c) {
+bool operator==(const Cell& lhs, const Cell& rhs) {
+	if (lhs.acell == nullptr || rhs.acell == nullptr)
+		return lhs.acell == rhs.acell;
+	return lhs.acell->equals(*rhs.acell);
+}
+
+bool operator!=(const Cell& lhs, const Cell& rhs) {
+	return !(lhs == rhs);
+}
+
+ostream& operator<<(ostream& out, const Cell& c) {
 	return c.acell->print(out);
 }
 
@@ -224,3 +301,1687 @@ bool Cell::is_alive() const {
 bool Cell::is_border() const {
 	return acell->is_border();
 }
+
+char Cell::symbol() const {
+	return acell->symbol();
+}
+
+// -----
+// Frame
+// -----
+
+namespace {
+const char frame_header[] = "Generation = %llu, Population = %llu.\n";
+}
+
+char* begin_frame(string& frame, unsigned long long generation, unsigned long long population, int h, int w) {
+	char header[80];
+	const int n = snprintf(header, sizeof(header), frame_header, generation, population);
+
+	frame.resize(n + static_cast<size_t>(h) * (w + 1) + 1);
+	char* p = &frame[0];
+	memcpy(p, header, n);
+
+	char* rows = p + n;
+	for (int x = 0; x < h; x++)
+		rows[x * (w + 1) + w] = '\n';
+	rows[static_cast<size_t>(h) * (w + 1)] = '\n';
+
+	return rows;
+}
+
+void write_all(int fd, const string& data) {
+	write_all(fd, data.data(), data.size());
+}
+
+void write_all(int fd, const char* p, size_t left) {
+	while (left > 0) {
+		const ssize_t n = write(fd, p, left);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			throw runtime_error("write failed");
+		}
+		p += n;
+		left -= n;
+	}
+}
+
+// --------
+// Snapshot
+// --------
+
+namespace {
+const char snapshot_magic[4] = {'\x89', 'L', 'I', 'F'};
+const uint32_t snapshot_version = 1;
+const uint32_t snapshot_byte_order = 0x01020304;
+}
+
+SnapshotHeader make_snapshot_header(uint32_t type, int h, int w, unsigned long long generation, unsigned long long population) {
+	assert(h >= 0 && w >= 0);
+
+	SnapshotHeader header;
+	memcpy(header.magic, snapshot_magic, 4);
+	header.version = snapshot_version;
+	header.byte_order = snapshot_byte_order;
+	header.type = type;
+	header.height = h;
+	header.width = w;
+	header.generation = generation;
+	header.population = population;
+	return header;
+}
+
+SnapshotLayout snapshot_layout(const SnapshotHeader& header) {
+	const size_t n = static_cast<size_t>(header.height) * header.width;
+
+	SnapshotLayout layout;
+	layout.bits = sizeof(SnapshotHeader);
+	layout.size = layout.bits + (n + 63) / 64 * 8;
+
+	layout.ages = 0;
+	if (header.type != CONWAY_BOARD) {
+		layout.ages = layout.size;
+		layout.size += n * 4;
+	}
+
+	layout.species = 0;
+	if (header.type == CELL_BOARD) {
+		layout.species = layout.size;
+		layout.size += n;
+	}
+
+	return layout;
+}
+
+bool is_snapshot(const char* first, const char* last) {
+	return last - first >= 4 && memcmp(first, snapshot_magic, 4) == 0;
+}
+
+SnapshotHeader read_snapshot_header(const char* first, const char* last, uint32_t type) {
+	if (last - first < static_cast<ptrdiff_t>(sizeof(SnapshotHeader)) || !is_snapshot(first, last))
+		throw runtime_error("not a snapshot");
+
+	SnapshotHeader header;
+	memcpy(&header, first, sizeof(header));
+
+	if (header.version != snapshot_version)
+		throw runtime_error("unknown snapshot version");
+	if (header.byte_order != snapshot_byte_order)
+		throw runtime_error("snapshot from a machine of another byte order");
+	if (header.type != type)
+		throw runtime_error("snapshot of another type of board");
+	if (header.height > INT32_MAX || header.width > INT32_MAX)
+		throw runtime_error("truncated snapshot");
+
+	// bound the cell count by the bytes there are before snapshot_layout() multiplies it
+	const size_t n = static_cast<size_t>(header.height) * header.width;
+	const size_t available = last - first;
+	if (n / 8 > available || (header.type != CONWAY_BOARD && n > available / 4))
+		throw runtime_error("truncated snapshot");
+	if (available < snapshot_layout(header).size)
+		throw runtime_error("truncated snapshot");
+
+	return header;
+}
+
+namespace {
+/**
+ * create a file of a name no one else has, next to path so it can be renamed
+ * over it, throws std::runtime_error on failure
+ * @param path the file that will be replaced
+ * @param temporary set to the name of the file made
+ * @return the file, open for writing
+ */
+int create_temporary(const string& path, string& temporary) {
+	vector<char> name(path.begin(), path.end());
+	const char suffix[] = ".XXXXXX";
+	name.insert(name.end(), suffix, suffix + sizeof(suffix));
+
+	const int fd = mkstemp(&name[0]);
+	if (fd < 0)
+		throw runtime_error("cannot create a temporary file for " + path);
+	temporary = &name[0];
+
+	// mkstemp makes the file private, the file it replaces was not
+	if (fchmod(fd, 0644) < 0) {
+		close(fd);
+		unlink(temporary.c_str());
+		throw runtime_error("cannot create " + temporary);
+	}
+	return fd;
+}
+}
+
+void write_file(const string& path, const string& data) {
+	string temporary;
+	const int fd = create_temporary(path, temporary);
+
+	try {
+		write_all(fd, data);
+	}
+	catch (...) {
+		close(fd);
+		unlink(temporary.c_str());
+		throw;
+	}
+
+	if (fsync(fd) < 0 || close(fd) < 0 || rename(temporary.c_str(), path.c_str()) < 0) {
+		unlink(temporary.c_str());
+		throw runtime_error("cannot write " + path);
+	}
+}
+
+void write_frame_file(const string& path, const string& rows, unsigned long long generation, unsigned long long population) {
+	const int in = open(rows.c_str(), O_RDONLY);
+	if (in < 0)
+		throw runtime_error("cannot open " + rows);
+
+	string temporary;
+	int fd;
+	try {
+		fd = create_temporary(path, temporary);
+	}
+	catch (...) {
+		close(in);
+		throw;
+	}
+
+	try {
+		char header[80];
+		write_all(fd, header, snprintf(header, sizeof(header), frame_header, generation, population));
+
+		string chunk(1 << 20, '\0');
+		ssize_t n;
+		while ((n = read(in, &chunk[0], chunk.size())) != 0) {
+			if (n < 0) {
+				if (errno == EINTR)
+					continue;
+				throw runtime_error("cannot read " + rows);
+			}
+			write_all(fd, chunk.data(), n);
+		}
+
+		write_all(fd, "\n", 1);
+	}
+	catch (...) {
+		close(in);
+		close(fd);
+		unlink(temporary.c_str());
+		throw;
+	}
+
+	close(in);
+	if (fsync(fd) < 0 || close(fd) < 0 || rename(temporary.c_str(), path.c_str()) < 0) {
+		unlink(temporary.c_str());
+		throw runtime_error("cannot write " + path);
+	}
+	unlink(rows.c_str());
+}
+
+// -----
+// Delta
+// -----
+
+namespace {
+const char keyframe_magic[4] = {'\x89', 'L', 'D', 'K'};
+const char changes_magic[4] = {'\x89', 'L', 'D', 'C'};
+const uint32_t delta_version = 1;
+
+struct KeyframeHeader {
+	char magic[4];				//"\x89LDK"
+	uint32_t version;			//format version
+	uint32_t byte_order;		//0x01020304 as written
+	uint32_t height;			//height of the board
+	uint32_t width;				//width of the board
+	uint32_t padding;			//always 0
+	uint64_t generation;		//generation of the frame
+	uint64_t population;		//population of the frame
+};
+
+struct ChangesHeader {
+	char magic[4];				//"\x89LDC"
+	uint32_t count;				//number of records that follow
+	uint64_t generation;		//generation after the changes
+	uint64_t population;		//population after the changes
+};
+}
+
+void append_delta_keyframe(string& out, DeltaFormat format, unsigned long long generation, unsigned long long population, int h, int w, const char* rows) {
+	assert(h >= 0 && w >= 0);
+
+	if (format == DELTA_TEXT) {
+		char header[120];
+		out.append(header, snprintf(header, sizeof(header), "Delta %d %d\nGeneration = %llu, Population = %llu.\n", h, w, generation, population));
+		out.append(rows, static_cast<size_t>(h) * (w + 1));
+		out += '\n';
+		return;
+	}
+
+	KeyframeHeader header;
+	memcpy(header.magic, keyframe_magic, 4);
+	header.version = delta_version;
+	header.byte_order = snapshot_byte_order;
+	header.height = h;
+	header.width = w;
+	header.padding = 0;
+	header.generation = generation;
+	header.population = population;
+	out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for (int x = 0; x < h; x++)
+		out.append(rows + static_cast<size_t>(x) * (w + 1), w);
+}
+
+void append_delta(string& out, DeltaFormat format, unsigned long long generation, unsigned long long population, const vector<DeltaRecord>& changes) {
+	if (format == DELTA_TEXT) {
+		char line[120];
+		out.append(line, snprintf(line, sizeof(line), "Generation = %llu, Population = %llu, Changes = %zu.\n", generation, population, changes.size()));
+		for (const DeltaRecord& r : changes)
+			out.append(line, snprintf(line, sizeof(line), "%c %d %d %c %d\n", r.kind, r.x, r.y, r.symbol, r.age));
+		out += '\n';
+		return;
+	}
+
+	ChangesHeader header;
+	memcpy(header.magic, changes_magic, 4);
+	header.count = static_cast<uint32_t>(changes.size());
+	header.generation = generation;
+	header.population = population;
+	out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!changes.empty())
+		out.append(reinterpret_cast<const char*>(&changes[0]), changes.size() * sizeof(DeltaRecord));
+}
+
+DeltaReader::DeltaReader(istream& s) :
+		in(s), started(false), height(0), width(0), last_generation(0), last_population(0), stale(true) {}
+
+bool DeltaReader::next() {
+	if (in.peek() == char_traits<char>::eof())
+		return false;
+
+	records.clear();
+	stale = true;
+
+	// a text delta never starts with the first byte of the binary magic
+	if (in.peek() == static_cast<unsigned char>(keyframe_magic[0])) {
+		char magic[4];
+		read_bytes(magic, 4);
+
+		if (memcmp(magic, keyframe_magic, 4) == 0) {
+			KeyframeHeader header;
+			memcpy(header.magic, magic, 4);
+			read_bytes(reinterpret_cast<char*>(&header) + 4, sizeof(header) - 4);
+			if (header.version != delta_version)
+				throw runtime_error("unknown delta version");
+			if (header.byte_order != snapshot_byte_order)
+				throw runtime_error("delta from a machine of another byte order");
+			if (header.height > INT32_MAX || header.width > INT32_MAX)
+				throw runtime_error("malformed delta");
+
+			height = header.height;
+			width = header.width;
+			last_generation = header.generation;
+			last_population = header.population;
+			read_elements(symbols, static_cast<size_t>(height) * width);
+			started = true;
+			return true;
+		}
+
+		if (memcmp(magic, changes_magic, 4) != 0 || !started)
+			throw runtime_error("malformed delta");
+
+		ChangesHeader header;
+		read_bytes(reinterpret_cast<char*>(&header) + 4, sizeof(header) - 4);
+		last_generation = header.generation;
+		last_population = header.population;
+		read_elements(records, header.count);
+	}
+	else {
+		string line;
+		getline(in, line);
+
+		int h, w;
+		if (sscanf(line.c_str(), "Delta %d %d", &h, &w) == 2) {
+			if (h < 0 || w < 0 || !getline(in, line) || sscanf(line.c_str(), "Generation = %llu, Population = %llu.", &last_generation, &last_population) != 2)
+				throw runtime_error("malformed delta");
+
+			height = h;
+			width = w;
+			symbols.clear();
+			for (int x = 0; x < height; x++) {
+				if (!getline(in, line) || static_cast<int>(line.size()) != width)
+					throw runtime_error("malformed delta");
+				symbols += line;
+			}
+			started = true;
+		}
+		else {
+			size_t n;
+			if (!started || sscanf(line.c_str(), "Generation = %llu, Population = %llu, Changes = %zu.", &last_generation, &last_population, &n) != 3)
+				throw runtime_error("malformed delta");
+
+			// n is only trusted as far as there are lines to back it
+			for (size_t i = 0; i < n; i++) {
+				DeltaRecord r;
+				char kind, symbol;
+				if (!getline(in, line) || sscanf(line.c_str(), "%c %d %d %c %d", &kind, &r.x, &r.y, &symbol, &r.age) != 5)
+					throw runtime_error("malformed delta");
+				r.kind = kind;
+				r.symbol = symbol;
+				r.padding[0] = r.padding[1] = 0;
+				records.push_back(r);
+			}
+		}
+
+		// the blank line that ends every generation
+		if (!getline(in, line) || !line.empty())
+			throw runtime_error("malformed delta");
+	}
+
+	for (const DeltaRecord& r : records) {
+		if (r.x < 0 || r.x >= height || r.y < 0 || r.y >= width)
+			throw runtime_error("delta record outside of the board");
+		symbols[static_cast<size_t>(r.x) * width + r.y] = r.symbol;
+	}
+
+	return true;
+}
+
+const string& DeltaReader::frame() {
+	if (stale) {
+		char* rows = begin_frame(rendered, last_generation, last_population, height, width);
+		for (int x = 0; x < height; x++)
+			memcpy(rows + static_cast<size_t>(x) * (width + 1), &symbols[static_cast<size_t>(x) * width], width);
+		stale = false;
+	}
+	return rendered;
+}
+
+const vector<DeltaRecord>& DeltaReader::changes() const {
+	return records;
+}
+
+unsigned long long DeltaReader::generation() const {
+	return last_generation;
+}
+
+unsigned long long DeltaReader::population() const {
+	return last_population;
+}
+
+void DeltaReader::read_bytes(void* p, size_t n) {
+	if (!in.read(static_cast<char*>(p), n))
+		throw runtime_error("truncated delta");
+}
+
+// ----------
+// MappedFile
+// ----------
+
+MappedFile::MappedFile(const string& path) : bytes(nullptr), length(0) {
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw runtime_error("cannot open " + path);
+
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		throw runtime_error("cannot stat " + path);
+	}
+
+	length = static_cast<size_t>(st.st_size);
+	if (length > 0) {
+		void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			close(fd);
+			throw runtime_error("cannot map " + path);
+		}
+		madvise(p, length, MADV_SEQUENTIAL);
+		bytes = static_cast<const char*>(p);
+	}
+
+	close(fd);
+}
+
+MappedFile::~MappedFile() {
+	if (bytes != nullptr)
+		munmap(const_cast<char*>(bytes), length);
+}
+
+const char* MappedFile::data() const {
+	return bytes;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
+
+// ------------
+// SharedMemory
+// ------------
+
+SharedMemory::SharedMemory(size_t size) : bytes(nullptr), length(size == 0 ? 1 : size) {
+	static atomic<unsigned> segments(0);
+	const string name = "/life-" + to_string(getpid()) + "-" + to_string(segments++);
+
+	const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0)
+		throw runtime_error("cannot create shared memory " + name);
+
+	// the mapping keeps the segment alive, nobody needs its name after this
+	shm_unlink(name.c_str());
+
+	if (ftruncate(fd, static_cast<off_t>(length)) < 0) {
+		close(fd);
+		throw runtime_error("cannot size shared memory " + name);
+	}
+
+	void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		throw runtime_error("cannot map shared memory " + name);
+
+	bytes = static_cast<char*>(p);
+}
+
+SharedMemory::~SharedMemory() {
+	munmap(bytes, length);
+}
+
+char* SharedMemory::data() const {
+	return bytes;
+}
+
+size_t SharedMemory::size() const {
+	return length;
+}
+
+// -------------
+// SharedBarrier
+// -------------
+
+namespace {
+/**
+ * sleep on a futex word shared between processes for at most 50 ms, unless
+ * it no longer holds the value expected
+ */
+void futex_wait(atomic<int>& word, int expected) {
+	timespec timeout = {0, 50000000};
+	syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+/**
+ * wake every process sleeping on a futex word
+ */
+void futex_wake_all(atomic<int>& word) {
+	syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+}
+
+SharedBarrier::SharedBarrier(int n) : parties(n), waiting(0), phase(0), broken(false) {
+	assert(n > 0);
+	static_assert(sizeof(atomic<int>) == sizeof(int) && ATOMIC_INT_LOCK_FREE == 2, "a futex word must be a plain int");
+}
+
+bool SharedBarrier::wait(const function<bool()>& healthy) {
+	if (broken)
+		return false;
+
+	// the phase cannot move on before this party arrives
+	const int arrival = phase.load(memory_order_acquire);
+	if (waiting.fetch_add(1, memory_order_acq_rel) + 1 == parties) {
+		waiting.store(0, memory_order_relaxed);
+		phase.fetch_add(1, memory_order_release);
+		futex_wake_all(phase);
+		return true;
+	}
+
+	while (phase.load(memory_order_acquire) == arrival) {
+		if (broken)
+			return false;
+		futex_wait(phase, arrival);
+		if (healthy && phase.load(memory_order_acquire) == arrival && !healthy())
+			abort();
+	}
+	return true;
+}
+
+void SharedBarrier::abort() {
+	broken = true;
+	futex_wake_all(phase);
+}
+
+// ------------
+// ProcessGroup
+// ------------
+
+ProcessGroup::ProcessGroup(int n, const function<void(int)>& work) {
+	assert(n > 0);
+
+	const pid_t parent = getpid();
+
+	for (int i = 0; i < n; i++) {
+		const pid_t p = fork();
+		if (p < 0) {
+			kill_all();
+			join();
+			throw runtime_error("cannot fork a worker");
+		}
+
+		if (p == 0) {
+			// die with the parent, even if it died before the signal was asked for
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+			if (getppid() != parent)
+				_exit(1);
+
+			// never return into the caller's stack, and leave its stdio buffers alone
+			int status = 0;
+			try {
+				work(i);
+			}
+			catch (...) {
+				status = 1;
+			}
+			_exit(status);
+		}
+
+		pids.push_back(p);
+		running.push_back(true);
+	}
+}
+
+ProcessGroup::~ProcessGroup() {
+	kill_all();
+	join();
+}
+
+int ProcessGroup::exited() {
+	for (size_t i = 0; i < pids.size(); i++) {
+		if (running[i] && waitpid(pids[i], nullptr, WNOHANG) == pids[i])
+			running[i] = false;
+		if (!running[i])
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+void ProcessGroup::join() {
+	for (size_t i = 0; i < pids.size(); i++) {
+		if (!running[i])
+			continue;
+		while (waitpid(pids[i], nullptr, 0) < 0 && errno == EINTR) {}
+		running[i] = false;
+	}
+}
+
+void ProcessGroup::kill_all() {
+	for (size_t i = 0; i < pids.size(); i++)
+		if (running[i])
+			kill(pids[i], SIGKILL);
+}
+
+pid_t ProcessGroup::pid(int i) const {
+	return pids.at(i);
+}
+
+// ----------
+// WorkerPool
+// ----------
+
+WorkerPool::WorkerPool(int threads) : job(nullptr), tasks(0), next_task(0), remaining(0), stopping(false) {
+	assert(threads > 0);
+
+	for (int i = 1; i < threads; i++)
+		workers.push_back(thread(&WorkerPool::work, this));
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (thread& t : workers)
+		t.join();
+}
+
+void WorkerPool::run(int n, const function<void(int)>& task) {
+	unique_lock<mutex> guard(lock);
+	job = &task;
+	tasks = n;
+	next_task = 0;
+	remaining = n;
+	wake.notify_all();
+
+	// the caller takes tasks too instead of sleeping
+	while (next_task < tasks) {
+		const int i = next_task++;
+		guard.unlock();
+		task(i);
+		guard.lock();
+		remaining--;
+	}
+
+	done.wait(guard, [this] { return remaining == 0; });
+	job = nullptr;
+}
+
+int WorkerPool::size() const {
+	return static_cast<int>(workers.size()) + 1;
+}
+
+void WorkerPool::work() {
+	unique_lock<mutex> guard(lock);
+
+	while (true) {
+		wake.wait(guard, [this] { return stopping || next_task < tasks; });
+
+		if (stopping)
+			return;
+
+		const int i = next_task++;
+		const function<void(int)>& task = *job;
+		guard.unlock();
+		task(i);
+		guard.lock();
+
+		if (--remaining == 0)
+			done.notify_all();
+	}
+}
+
+// ----------------
+// WorkStealingPool
+// ----------------
+
+WorkStealingPool::WorkStealingPool(int n) : threads(n) {
+	assert(n > 0);
+
+	for (int i = 0; i < n; i++)
+		queues.push_back(unique_ptr<Queue>(new Queue));
+}
+
+void WorkStealingPool::run(int n, const function<void(int)>& task) {
+	// deal the tasks out in blocks, so neighbouring tasks start on one thread
+	for (int i = 0; i < threads; i++) {
+		Queue& q = *queues[i];
+		for (int t = n * i / threads; t < n * (i + 1) / threads; t++)
+			q.tasks.push_back(t);
+	}
+	error = nullptr;
+
+	vector<thread> workers;
+	for (int i = 1; i < threads; i++)
+		workers.push_back(thread(&WorkStealingPool::work, this, i, cref(task)));
+
+	// the caller takes tasks too instead of sleeping
+	work(0, task);
+
+	for (thread& t : workers)
+		t.join();
+
+	if (error)
+		rethrow_exception(error);
+}
+
+int WorkStealingPool::size() const {
+	return threads;
+}
+
+bool WorkStealingPool::take(int self, int& task) {
+	{
+		Queue& own = *queues[self];
+		lock_guard<mutex> guard(own.lock);
+		if (!own.tasks.empty()) {
+			task = own.tasks.back();
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// no task is ever added during a run, so finding every queue empty once is final
+	for (int i = 1; i < threads; i++) {
+		Queue& victim = *queues[(self + i) % threads];
+		lock_guard<mutex> guard(victim.lock);
+		if (!victim.tasks.empty()) {
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingPool::work(int self, const function<void(int)>& task) {
+	int t;
+	while (take(self, t)) {
+		try {
+			task(t);
+		}
+		catch (...) {
+			lock_guard<mutex> guard(error_lock);
+			if (!error)
+				error = current_exception();
+		}
+	}
+}
+
+// -----------
+// FrameWriter
+// -----------
+
+FrameWriter::FrameWriter(ostream& o, size_t n) : out(o), limit(n), finishing(false) {
+	assert(n > 0);
+	writer = thread(&FrameWriter::work, this);
+}
+
+FrameWriter::~FrameWriter() {
+	finish();
+}
+
+void FrameWriter::push(string& frame) {
+	unique_lock<mutex> guard(lock);
+	assert(!finishing);
+
+	changed.wait(guard, [this] { return frames.size() < limit; });
+	frames.push_back(string());
+	frames.back().swap(frame);
+
+	if (!spare.empty()) {
+		frame.swap(spare.back());
+		spare.pop_back();
+	}
+
+	changed.notify_all();
+}
+
+void FrameWriter::finish() {
+	{
+		lock_guard<mutex> guard(lock);
+		if (finishing)
+			return;
+		finishing = true;
+	}
+	changed.notify_all();
+
+	writer.join();
+	out.flush();
+}
+
+void FrameWriter::work() {
+	unique_lock<mutex> guard(lock);
+
+	while (true) {
+		changed.wait(guard, [this] { return finishing || !frames.empty(); });
+		if (frames.empty())
+			return;
+
+		string frame;
+		frame.swap(frames.front());
+		frames.pop_front();
+
+		guard.unlock();
+		out.write(frame.data(), frame.size());
+		guard.lock();
+
+		if (spare.size() < limit)
+			spare.push_back(std::move(frame));
+		changed.notify_all();
+	}
+}
+
+// -----
+// Batch
+// -----
+
+namespace {
+	/**
+	 * run a job on a board of T
+	 * @param job the job
+	 * @return its output
+	 */
+	template <class T>
+	string run_job_with(const LifeJob& job) {
+		Life<T> l(job.board.data(), job.board.data() + job.board.size());
+		l.set_cycle_detection(job.cycle_history);
+
+		string out = job.title;
+		if (job.prints.empty()) {
+			l.jump_to(job.generations);
+			out += l.render();
+		}
+
+		for (int g : job.prints) {
+			assert(g <= job.generations);
+			l.jump_to(g);
+			out += l.render();
+		}
+
+		return out;
+	}
+}
+
+string run_job(const LifeJob& job) {
+	switch (job.cells) {
+	case CONWAY_CELLS:
+		return run_job_with<ConwayCell>(job);
+	case FREDKIN_CELLS:
+		return run_job_with<FredkinCell>(job);
+	default:
+		return run_job_with<Cell>(job);
+	}
+}
+
+vector<string> run_batch(const vector<LifeJob>& jobs, int threads) {
+	vector<string> results(jobs.size());
+
+	WorkStealingPool pool(threads);
+	pool.run(static_cast<int>(jobs.size()), [&jobs, &results](int i) {
+		results[i] = run_job(jobs[i]);
+	});
+
+	return results;
+}
+
+void run_batch(const vector<LifeJob>& jobs, int threads, ostream& out) {
+	const size_t n = jobs.size();
+	vector<string> results(n);
+	vector<char> ready(n, false);
+	size_t next = 0;		// the first job not written yet
+	bool pushing = false;	// is a worker handing outputs to the writer?
+	mutex lock;
+
+	// a job's output is written as soon as every job before it is done. One
+	// worker at a time pushes, without the lock, so while the writer is full
+	// only that worker waits and the others go on to their next job
+	FrameWriter writer(out, max(threads, 4));
+	WorkStealingPool pool(threads);
+	pool.run(static_cast<int>(n), [&](int i) {
+		string result = run_job(jobs[i]);
+
+		unique_lock<mutex> guard(lock);
+		results[i].swap(result);
+		ready[i] = true;
+		if (pushing)
+			return;		// the worker pushing picks it up
+
+		pushing = true;
+		while (next < n && ready[next]) {
+			string frame;
+			frame.swap(results[next++]);
+			guard.unlock();
+			writer.push(frame);
+			guard.lock();
+		}
+		pushing = false;
+	});
+
+	writer.finish();
+}
+
+// ----
+// Rows
+// ----
+
+namespace {
+/**
+ * throw std::runtime_error unless cell (x, y) read from a stream is on a
+ * board of h rows of w cells
+ */
+void check_cell(int x, int y, int h, int w) {
+	if (x >= h)
+		throw runtime_error("board has more than " + to_string(h) + " rows");
+	if (y >= w)
+		throw runtime_error("row " + to_string(x) + " is more than " + to_string(w) + " cells wide");
+}
+
+/**
+ * throw std::runtime_error unless row x ended after w cells
+ */
+void check_row_end(int x, int y, int w) {
+	if (y != w)
+		throw runtime_error("row " + to_string(x) + " is " + to_string(y) + " cells wide, not " + to_string(w));
+}
+
+/**
+ * throw std::runtime_error unless x rows were read of a board of h rows
+ */
+void check_rows(int x, int h) {
+	if (x != h)
+		throw runtime_error("board has " + to_string(x) + " rows, not " + to_string(h));
+}
+}
+
+// ----------
+// ConwayLife
+// ----------
+
+namespace {
+	int popcount(uint64_t w) {
+		return __builtin_popcountll(w);
+	}
+}
+
+ConwayLife::ConwayLife(istream& in, int h, int w) {
+	width = w;
+	height = h;
+	generation = 0;
+	population = 0;
+
+	stride = (width + 63) / 64 + 2;
+	last_mask = (width % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (width % 64)) - 1;
+
+	cells.assign((height + 2) * stride, 0);
+	next.assign((height + 2) * stride, 0);
+
+	int x = 0;
+	int y = 0;
+
+	while (true) {
+		int input = in.get();
+
+		if (input == EOF || (input == '\n' && y == 0))
+			break;
+
+		if (input == '\n') {
+			check_row_end(x, y, width);
+			x++;
+			y = 0;
+			continue;
+		}
+
+		check_cell(x, y, height, width);
+		if (input != '*' && input != '.')
+			throw runtime_error(string("'") + static_cast<char>(input) + "' is not a Conway cell");
+
+		if (input == '*') {
+			set(x, y, true);
+			population++;
+		}
+
+		y++;
+	}
+
+	check_rows(x, height);
+}
+
+bool ConwayLife::get(int x, int y) const {
+	return (cells[(x + 1) * stride + 1 + y / 64] >> (y % 64)) & 1;
+}
+
+void ConwayLife::set(int x, int y, bool alive) {
+	uint64_t& word = cells[(x + 1) * stride + 1 + y / 64];
+	if (alive)
+		word |= uint64_t(1) << (y % 64);
+	else
+		word &= ~(uint64_t(1) << (y % 64));
+}
+
+const ConwayCell ConwayLife::at(int x, int y) const {
+	if (x < 0 || x >= height || y < 0 || y >= width)
+		throw out_of_range("ConwayLife::at");
+	return ConwayCell(get(x, y) ? '*' : '.');
+}
+
+void ConwayLife::evolve_all() {
+	population = 0;
+
+	const int words = stride - 2;
+
+	for (int x = 1; x < height + 1; x++) {
+		const uint64_t* up = &cells[(x - 1) * stride];
+		const uint64_t* mid = &cells[x * stride];
+		const uint64_t* down = &cells[(x + 1) * stride];
+		uint64_t* out = &next[x * stride];
+
+		// straight-line bit-sliced adder, the compiler is free to vectorize it
+		for (int k = 1; k < words + 1; k++) {
+			const uint64_t u = up[k], m = mid[k], d = down[k];
+
+			const uint64_t uw = (u << 1) | (up[k - 1] >> 63);
+			const uint64_t ue = (u >> 1) | (up[k + 1] << 63);
+			const uint64_t mw = (m << 1) | (mid[k - 1] >> 63);
+			const uint64_t me = (m >> 1) | (mid[k + 1] << 63);
+			const uint64_t dw = (d << 1) | (down[k - 1] >> 63);
+			const uint64_t de = (d >> 1) | (down[k + 1] << 63);
+
+			// row above and row below through full adders, the sides through a half adder
+			const uint64_t us = uw ^ u ^ ue, uc = (uw & u) | (ue & (uw ^ u));
+			const uint64_t ds = dw ^ d ^ de, dc = (dw & d) | (de & (dw ^ d));
+			const uint64_t ms = mw ^ me, mc = mw & me;
+
+			// ones
+			const uint64_t ones = us ^ ds ^ ms;
+			const uint64_t c1 = (us & ds) | (ms & (us ^ ds));
+
+			// twos, anything that carries into the fours means 4 or more neighbors
+			const uint64_t t = uc ^ dc ^ mc;
+			const uint64_t f1 = (uc & dc) | (mc & (uc ^ dc));
+			const uint64_t twos = t ^ c1;
+			const uint64_t f2 = t & c1;
+
+			// alive next iff 3 neighbors, or alive now and 2 neighbors
+			out[k] = twos & ~(f1 | f2) & (ones | m);
+		}
+
+		out[words] &= last_mask;
+
+		for (int k = 1; k < words + 1; k++)
+			population += popcount(out[k]);
+	}
+
+	cells.swap(next);
+	generation++;
+}
+
+void ConwayLife::print(ostream& out) {
+	char* rows = begin_frame(frame, generation, population, height, width);
+
+	for (int x = 0; x < height; x++)
+		for (int y = 0; y < width; y++)
+			rows[x * (width + 1) + y] = get(x, y) ? '*' : '.';
+
+	out.write(frame.data(), frame.size());
+	out.flush();
+}
+
+// -----------
+// FredkinLife
+// -----------
+
+FredkinLife::FredkinLife(istream& in, int h, int w) {
+	width = w;
+	height = h;
+	generation = 0;
+	population = 0;
+
+	alive.assign((height + 2) * (width + 2), 0);
+	ages.assign((height + 2) * (width + 2), 0);
+
+	int x = 0;
+	int y = 0;
+
+	while (true) {
+		int input = in.get();
+
+		if (input == EOF || (input == '\n' && y == 0))
+			break;
+
+		if (input == '\n') {
+			check_row_end(x, y, width);
+			x++;
+			y = 0;
+			continue;
+		}
+
+		check_cell(x, y, height, width);
+
+		const FredkinCell c(static_cast<char>(input));
+		const int i = (x + 1) * (width + 2) + y + 1;
+		alive[i] = c.is_alive();
+		ages[i] = c.age();
+		population += c.is_alive();
+
+		y++;
+	}
+
+	check_rows(x, height);
+
+	next_alive = alive;		// borders of the back buffers never change
+	next_ages = ages;
+}
+
+const FredkinCell FredkinLife::at(int x, int y) const {
+	if (x < 0 || x >= height || y < 0 || y >= width)
+		throw out_of_range("FredkinLife::at");
+	const int i = (x + 1) * (width + 2) + y + 1;
+	return FredkinCell(ages[i], alive[i] != 0);
+}
+
+void FredkinLife::evolve_all() {
+	// B13/S13 on 4 neighbors comes down to an odd count, alive or not, which
+	// unlike the variable shift in FredkinRule::next() vectorizes everywhere
+	static_assert(FredkinRule::table == (counts(1, 3) | (counts(1, 3) << 9) | (VON_NEUMANN << 18)), "FredkinRule is no longer parity");
+
+	const int w = width;	// locals, the byte stores below could alias the members otherwise
+	const int s = w + 2;
+	int count = 0;
+
+	for (int x = 1; x < height + 1; x++) {
+		const uint8_t* __restrict__ up = &alive[(x - 1) * s];
+		const uint8_t* __restrict__ mid = &alive[x * s];
+		const uint8_t* __restrict__ down = &alive[(x + 1) * s];
+		const int* __restrict__ age = &ages[x * s];
+		uint8_t* __restrict__ out = &next_alive[x * s];
+		int* __restrict__ out_age = &next_ages[x * s];
+
+		// no branches and no cells, only bytes and ints, the compiler is free to vectorize it
+		for (int y = 1; y < w + 1; y++) {
+			const int live_neighbors = up[y] + mid[y + 1] + down[y] + mid[y - 1];
+			const int a = live_neighbors & 1;
+
+			out[y] = static_cast<uint8_t>(a);
+			out_age[y] = age[y] + (mid[y] & a);
+			count += a;
+		}
+	}
+
+	population = count;
+	alive.swap(next_alive);
+	ages.swap(next_ages);
+	generation++;
+}
+
+void FredkinLife::print(ostream& out) {
+	char* rows = begin_frame(frame, generation, population, height, width);
+
+	for (int x = 0; x < height; x++) {
+		const uint8_t* a = &alive[(x + 1) * (width + 2) + 1];
+		const int* age = &ages[(x + 1) * (width + 2) + 1];
+
+		for (int y = 0; y < width; y++)
+			rows[x * (width + 1) + y] = !a[y] ? '-' : (age[y] < 10 ? static_cast<char>('0' + age[y]) : '+');
+	}
+
+	out.write(frame.data(), frame.size());
+	out.flush();
+}
+
+// ---------
+// MixedLife
+// ---------
+
+MixedLife::MixedLife(istream& in, int h, int w) {
+	width = w;
+	height = h;
+	generation = 0;
+	population = 0;
+
+	species.assign((height + 2) * (width + 2), CONWAY);
+	alive.assign((height + 2) * (width + 2), 0);
+	ages.assign((height + 2) * (width + 2), 0);
+
+	int x = 0;
+	int y = 0;
+
+	while (true) {
+		int input = in.get();
+
+		if (input == EOF || (input == '\n' && y == 0))
+			break;
+
+		if (input == '\n') {
+			check_row_end(x, y, width);
+			x++;
+			y = 0;
+			continue;
+		}
+
+		check_cell(x, y, height, width);
+
+		const Cell c(static_cast<char>(input));
+		const int i = (x + 1) * (width + 2) + y + 1;
+		species[i] = CellTraits<Cell>::species(c);
+		alive[i] = c.is_alive();
+		ages[i] = CellTraits<Cell>::age(c);
+		population += c.is_alive();
+
+		y++;
+	}
+
+	check_rows(x, height);
+
+	next_species = species;		// borders of the back buffers never change
+	next_alive = alive;
+	next_ages = ages;
+}
+
+const Cell MixedLife::at(int x, int y) const {
+	if (x < 0 || x >= height || y < 0 || y >= width)
+		throw out_of_range("MixedLife::at");
+	const int i = (x + 1) * (width + 2) + y + 1;
+	return CellTraits<Cell>::make(species[i], alive[i] != 0, ages[i]);
+}
+
+namespace {
+	/**
+	 * evolve one row of a MixedLife board, the pointers are to the start of
+	 * the padded row and never overlap, as the compiler may assume
+	 * @return the population of the row in the next generation
+	 */
+	int evolve_mixed_row(int w, const uint8_t* __restrict__ up, const uint8_t* __restrict__ mid, const uint8_t* __restrict__ down,
+			const uint8_t* __restrict__ kind, const int* __restrict__ age,
+			uint8_t* __restrict__ out, uint8_t* __restrict__ out_kind, int* __restrict__ out_age) {
+		int count = 0;
+
+		// every cell works out both rules and keeps the one its tag picks
+		for (int y = 1; y < w + 1; y++) {
+			const int orthogonal = up[y] + mid[y + 1] + down[y] + mid[y - 1];
+			const int all = orthogonal + up[y - 1] + up[y + 1] + down[y - 1] + down[y + 1];
+			const int a = mid[y];
+			const int fredkin = kind[y];
+
+			const int conway_next = (all == 3) | (a & (all == 2));
+			const int fredkin_next = orthogonal & 1;
+			const int next = fredkin ? fredkin_next : conway_next;
+
+			// a fredkin cell that survives at age 1 turns into a live conway cell
+			const int promoted = fredkin & a & next & (age[y] == 1);
+			const int next_age = fredkin ? age[y] + (a & next) : 0;
+
+			out[y] = static_cast<uint8_t>(next);
+			out_kind[y] = static_cast<uint8_t>(fredkin & !promoted);
+			out_age[y] = promoted ? 0 : next_age;
+			count += next;
+		}
+
+		return count;
+	}
+}
+
+void MixedLife::evolve_all() {
+	// both rules come down to comparisons on the counts, see FredkinLife::evolve_all()
+	static_assert(ConwayRule::table == (counts(3) | (counts(2, 3) << 9)), "ConwayRule is no longer B3/S23");
+	static_assert(FredkinRule::table == (counts(1, 3) | (counts(1, 3) << 9) | (VON_NEUMANN << 18)), "FredkinRule is no longer parity");
+
+	const int s = width + 2;
+	population = 0;
+
+	for (int x = 1; x < height + 1; x++)
+		population += evolve_mixed_row(width, &alive[(x - 1) * s], &alive[x * s], &alive[(x + 1) * s],
+				&species[x * s], &ages[x * s], &next_alive[x * s], &next_species[x * s], &next_ages[x * s]);
+
+	species.swap(next_species);
+	alive.swap(next_alive);
+	ages.swap(next_ages);
+	generation++;
+}
+
+void MixedLife::print(ostream& out) {
+	char* rows = begin_frame(frame, generation, population, height, width);
+
+	for (int x = 0; x < height; x++) {
+		const uint8_t* kind = &species[(x + 1) * (width + 2) + 1];
+		const uint8_t* a = &alive[(x + 1) * (width + 2) + 1];
+		const int* age = &ages[(x + 1) * (width + 2) + 1];
+
+		for (int y = 0; y < width; y++) {
+			char c;
+			if (kind[y] == CONWAY)
+				c = a[y] ? '*' : '.';
+			else
+				c = !a[y] ? '-' : (age[y] < 10 ? static_cast<char>('0' + age[y]) : '+');
+			rows[x * (width + 1) + y] = c;
+		}
+	}
+
+	out.write(frame.data(), frame.size());
+	out.flush();
+}
+
+// --------
+// HashLife
+// --------
+
+namespace {
+// the root is a square of side 2^level at long long coordinates
+const int hashlife_max_level = 63;
+}
+
+HashLife::HashLife(istream& in, int h, int w) {
+	height = h;
+	width = w;
+	generation = 0;
+	cache_limit = 1 << 22;
+
+	const Node dead = {0, 0, 0, 0, 0, 0, 0, -1};
+	const Node alive = {0, 0, 0, 0, 0, 1, 0, -1};
+	nodes.push_back(dead);
+	nodes.push_back(alive);
+	empties.push_back(0);
+
+	vector<char> cells(height * width, 0);
+
+	int x = 0;
+	int y = 0;
+
+	while (true) {
+		int input = in.get();
+
+		if (input == EOF || (input == '\n' && y == 0))
+			break;
+
+		if (input == '\n') {
+			check_row_end(x, y, width);
+			x++;
+			y = 0;
+			continue;
+		}
+
+		check_cell(x, y, height, width);
+		if (input != '*' && input != '.')
+			throw runtime_error(string("'") + static_cast<char>(input) + "' is not a Conway cell");
+
+		cells[x * width + y] = (input == '*');
+		y++;
+	}
+
+	check_rows(x, height);
+
+	int level = 2;
+	while ((1LL << level) < max(height, width))
+		level++;
+
+	root = build(cells, level, 0, 0);
+	origin_x = 0;
+	origin_y = 0;
+}
+
+uint32_t HashLife::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+	const Key k = {nw, ne, sw, se};
+	unordered_map<Key, uint32_t, KeyHash>::const_iterator i = table.find(k);
+	if (i != table.end())
+		return i->second;
+
+	const Node n = {nw, ne, sw, se, nodes[nw].level + 1,
+		nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population, 0, -1};
+	const uint32_t id = static_cast<uint32_t>(nodes.size());
+	nodes.push_back(n);
+	table[k] = id;
+	return id;
+}
+
+uint32_t HashLife::empty(int level) {
+	while (static_cast<int>(empties.size()) <= level) {
+		const uint32_t e = empties.back();
+		empties.push_back(join(e, e, e, e));
+	}
+	return empties[level];
+}
+
+uint32_t HashLife::center(uint32_t n) {
+	const Node& c = nodes[n];
+	return join(nodes[c.nw].se, nodes[c.ne].sw, nodes[c.sw].ne, nodes[c.se].nw);
+}
+
+uint32_t HashLife::successor_leaf(uint32_t n) {
+	// lay the 4x4 square out as bits, row major
+	const Node& c = nodes[n];
+	const uint32_t quadrants[4] = {c.nw, c.ne, c.sw, c.se};
+	int bits[4][4];
+	for (int q = 0; q < 4; q++) {
+		const Node& d = nodes[quadrants[q]];
+		const int x = (q / 2) * 2;
+		const int y = (q % 2) * 2;
+		bits[x][y] = static_cast<int>(d.nw);
+		bits[x][y + 1] = static_cast<int>(d.ne);
+		bits[x + 1][y] = static_cast<int>(d.sw);
+		bits[x + 1][y + 1] = static_cast<int>(d.se);
+	}
+
+	uint32_t next[4];
+	for (int q = 0; q < 4; q++) {
+		const int x = 1 + q / 2;
+		const int y = 1 + q % 2;
+
+		int live_neighbors = 0;
+		for (int i = -1; i <= 1; i++)
+			for (int j = -1; j <= 1; j++)
+				if (i != 0 || j != 0)
+					live_neighbors += bits[x + i][y + j];
+
+		next[q] = (live_neighbors == 3 || (bits[x][y] && live_neighbors == 2)) ? 1 : 0;
+	}
+
+	return join(next[0], next[1], next[2], next[3]);
+}
+
+uint32_t HashLife::successor(uint32_t n, int step) {
+	const int level = nodes[n].level;
+	assert(level >= 2);
+
+	step = min(step, level - 2);
+
+	if (nodes[n].result_step == step)
+		return nodes[n].result;
+
+	uint32_t result;
+
+	if (nodes[n].population == 0)
+		result = empty(level - 1);
+	else if (level == 2)
+		result = successor_leaf(n);
+	else {
+		const Node c = nodes[n];
+		const Node nw = nodes[c.nw], ne = nodes[c.ne], sw = nodes[c.sw], se = nodes[c.se];
+
+		// nine overlapping squares of level - 1
+		const uint32_t n00 = c.nw;
+		const uint32_t n01 = join(nw.ne, ne.nw, nw.se, ne.sw);
+		const uint32_t n02 = c.ne;
+		const uint32_t n10 = join(nw.sw, nw.se, sw.nw, sw.ne);
+		const uint32_t n11 = join(nw.se, ne.sw, sw.ne, se.nw);
+		const uint32_t n12 = join(ne.sw, ne.se, se.nw, se.ne);
+		const uint32_t n20 = c.sw;
+		const uint32_t n21 = join(sw.ne, se.nw, sw.se, se.sw);
+		const uint32_t n22 = c.se;
+
+		const uint32_t r00 = successor(n00, step);
+		const uint32_t r01 = successor(n01, step);
+		const uint32_t r02 = successor(n02, step);
+		const uint32_t r10 = successor(n10, step);
+		const uint32_t r11 = successor(n11, step);
+		const uint32_t r12 = successor(n12, step);
+		const uint32_t r20 = successor(n20, step);
+		const uint32_t r21 = successor(n21, step);
+		const uint32_t r22 = successor(n22, step);
+
+		const uint32_t a = join(r00, r01, r10, r11);
+		const uint32_t b = join(r01, r02, r11, r12);
+		const uint32_t d = join(r10, r11, r20, r21);
+		const uint32_t e = join(r11, r12, r21, r22);
+
+		if (step == level - 2)	// full speed, the second half of the generations
+			result = join(successor(a, step), successor(b, step), successor(d, step), successor(e, step));
+		else
+			result = join(center(a), center(b), center(d), center(e));
+	}
+
+	nodes[n].result = result;
+	nodes[n].result_step = step;
+	return result;
+}
+
+uint32_t HashLife::build(const vector<char>& cells, int level, long long x0, long long y0) {
+	if (x0 >= height || y0 >= width)
+		return empty(level);
+
+	if (level == 0)
+		return cells[x0 * width + y0] ? 1 : 0;
+
+	const long long half = 1LL << (level - 1);
+	const uint32_t nw = build(cells, level - 1, x0, y0);
+	const uint32_t ne = build(cells, level - 1, x0, y0 + half);
+	const uint32_t sw = build(cells, level - 1, x0 + half, y0);
+	const uint32_t se = build(cells, level - 1, x0 + half, y0 + half);
+	return join(nw, ne, sw, se);
+}
+
+void HashLife::expand() {
+	if (nodes[root].level >= hashlife_max_level)
+		throw overflow_error("HashLife::expand");
+
+	const Node c = nodes[root];
+	const uint32_t e = empty(c.level - 1);
+	const long long quarter = 1LL << (c.level - 1);
+
+	const uint32_t nw = join(e, e, e, c.nw);
+	const uint32_t ne = join(e, e, c.ne, e);
+	const uint32_t sw = join(e, c.sw, e, e);
+	const uint32_t se = join(c.se, e, e, e);
+	root = join(nw, ne, sw, se);
+
+	origin_x -= quarter;
+	origin_y -= quarter;
+}
+
+bool HashLife::centered() const {
+	const Node& c = nodes[root];
+	const Node& nw = nodes[c.nw];
+	const Node& ne = nodes[c.ne];
+	const Node& sw = nodes[c.sw];
+	const Node& se = nodes[c.se];
+
+	return nodes[root].population == nodes[nw.se].population + nodes[ne.sw].population
+		+ nodes[sw.ne].population + nodes[se.nw].population;
+}
+
+void HashLife::step(int step) {
+	// the root ends up at least three levels above the step
+	if (step < 0 || step + 3 > hashlife_max_level)
+		throw overflow_error("HashLife::step");
+
+	while (nodes[root].level < step + 2 || !centered())
+		expand();
+	expand();	// room for the pattern to grow 2^step cells every way
+
+	const long long quarter = 1LL << (nodes[root].level - 2);
+	root = successor(root, step);
+	origin_x += quarter;
+	origin_y += quarter;
+
+	generation += 1ULL << step;
+
+	if (nodes.size() > cache_limit)
+		collect();
+}
+
+void HashLife::advance(unsigned long long generations) {
+	// checked up front so a jump too far leaves the plane as it was
+	if (generations >> (hashlife_max_level - 2))
+		throw overflow_error("HashLife::advance");
+
+	for (int j = 0; j < 64; j++)
+		if ((generations >> j) & 1)
+			step(j);
+}
+
+void HashLife::jump_to(unsigned long long target) {
+	if (target < generation)
+		throw invalid_argument("HashLife::jump_to");
+	advance(target - generation);
+}
+
+void HashLife::set_cache_limit(size_t limit) {
+	cache_limit = limit;
+	if (nodes.size() > cache_limit)
+		collect();
+}
+
+void HashLife::mark(uint32_t n, vector<char>& live) const {
+	if (live[n])
+		return;
+	live[n] = 1;
+	if (nodes[n].level > 0) {
+		mark(nodes[n].nw, live);
+		mark(nodes[n].ne, live);
+		mark(nodes[n].sw, live);
+		mark(nodes[n].se, live);
+	}
+}
+
+void HashLife::collect() {
+	vector<char> live(nodes.size(), 0);
+	live[0] = live[1] = 1;
+	mark(root, live);
+	for (size_t l = 0; l < empties.size(); l++)
+		mark(empties[l], live);
+
+	// children always come before their parents, so one pass renumbers everything
+	vector<uint32_t> id(nodes.size(), 0);
+	vector<Node> kept;
+	kept.reserve(nodes.size());
+	table.clear();
+
+	for (size_t n = 0; n < nodes.size(); n++) {
+		if (!live[n])
+			continue;
+
+		Node c = nodes[n];
+		if (c.level > 0) {
+			c.nw = id[c.nw];
+			c.ne = id[c.ne];
+			c.sw = id[c.sw];
+			c.se = id[c.se];
+			const Key k = {c.nw, c.ne, c.sw, c.se};
+			table[k] = static_cast<uint32_t>(kept.size());
+		}
+		c.result_step = -1;
+
+		id[n] = static_cast<uint32_t>(kept.size());
+		kept.push_back(c);
+	}
+
+	nodes.swap(kept);
+	root = id[root];
+	for (size_t l = 0; l < empties.size(); l++)
+		empties[l] = id[empties[l]];
+}
+
+void HashLife::render(uint32_t n, long long x0, long long y0, vector<char>& cells) const {
+	const Node& c = nodes[n];
+	const long long side = 1LL << c.level;
+
+	if (c.population == 0 || x0 >= height || y0 >= width || x0 + side <= 0 || y0 + side <= 0)
+		return;
+
+	if (c.level == 0) {
+		cells[x0 * width + y0] = 1;
+		return;
+	}
+
+	const long long half = side / 2;
+	render(c.nw, x0, y0, cells);
+	render(c.ne, x0, y0 + half, cells);
+	render(c.sw, x0 + half, y0, cells);
+	render(c.se, x0 + half, y0 + half, cells);
+}
+
+const ConwayCell HashLife::at(long long x, long long y) const {
+	uint32_t n = root;
+	long long x0 = origin_x;
+	long long y0 = origin_y;
+
+	if (x < x0 || y < y0 || x >= x0 + (1LL << nodes[n].level) || y >= y0 + (1LL << nodes[n].level))
+		return ConwayCell('.');
+
+	while (nodes[n].level > 0) {
+		const long long half = 1LL << (nodes[n].level - 1);
+		const bool south = x >= x0 + half;
+		const bool east = y >= y0 + half;
+		if (south)
+			x0 += half;
+		if (east)
+			y0 += half;
+		n = south ? (east ? nodes[n].se : nodes[n].sw) : (east ? nodes[n].ne : nodes[n].nw);
+	}
+
+	return ConwayCell(n == 1 ? '*' : '.');
+}
+
+void HashLife::print(ostream& out) {
+	vector<char> cells(height * width, 0);
+	render(root, origin_x, origin_y, cells);
+
+	char* rows = begin_frame(frame, generation, nodes[root].population, height, width);
+
+	for (int x = 0; x < height; x++)
+		for (int y = 0; y < width; y++)
+			rows[x * (width + 1) + y] = cells[x * width + y] ? '*' : '.';
+
+	out.write(frame.data(), frame.size());
+	out.flush();
+}
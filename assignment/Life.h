@@ -2,12 +2,132 @@
 #define Life_h
 
 #include <vector>
+#include <cassert>
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <memory>
+#include <iterator>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <deque>
+#include <unordered_map>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+#ifdef LIFE_STATS
+#include <chrono>
+#endif
+
+#include <sys/types.h>
 
 #include "gtest/gtest.h"
 
 class Cell;
 
+// 	-------------------------------------------------------------------------
+//	Class Neighborhood is a read-only view of the 8 neighbors of a cell, in
+//	the order documented on AbstractCell, without copying any of them
+// 	-------------------------------------------------------------------------
+template <class T>
+class Neighborhood {
+public:
+
+	/**
+	 * constructor, a view over a plain array of 8 neighbors
+	 * @param neighbors the neighbors in order
+	 */
+	explicit Neighborhood(const T neighbors[8]) : center(neighbors), offsets(identity) {}
+
+	/**
+	 * constructor, a view over the neighbors of a cell that lives in a grid
+	 * @param c the cell whose neighbors are viewed
+	 * @param o the offset from c to each of its 8 neighbors
+	 */
+	Neighborhood(const T* c, const std::ptrdiff_t o[8]) : center(c), offsets(o) {}
+
+	/**
+	 * operator [] will return the ith neighbor
+	 * @param i the index of the neighbor
+	 * @return a reference to the neighbor
+	 */
+	const T& operator[](int i) const {
+		return center[offsets[i]];
+	}
+
+private:
+	const T* center;				//the cell, or the first neighbor for an array
+	const std::ptrdiff_t* offsets;	//offset of every neighbor from center
+
+	static const std::ptrdiff_t identity[8];
+};
+
+template <class T>
+const std::ptrdiff_t Neighborhood<T>::identity[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+/**
+ * a set of neighbor counts as a bit mask, for the template arguments of Rule
+ * @return the mask, bit n set for every count n given
+ */
+constexpr unsigned counts() {
+	return 0;
+}
+
+template <class... Counts>
+constexpr unsigned counts(int n, Counts... rest) {
+	return (1u << n) | counts(rest...);
+}
+
+//	which neighbors a rule counts
+enum Shape {
+	MOORE,			//all 8
+	VON_NEUMANN		//only up, right, down and left, the first 4
+};
+
+// 	-------------------------------------------------------------------------
+//	Struct Rule is a life-like rule, settled at compile time. Birth and
+//	Survive are the masks of live neighbor counts, built with counts(), that
+//	bring a dead cell to life and keep a live cell alive
+// 	-------------------------------------------------------------------------
+template <unsigned Birth, unsigned Survive, Shape N = MOORE>
+struct Rule {
+	static const int neighbors = (N == MOORE) ? 8 : 4;	//neighbors counted, the first in the usual order
+
+	static const std::uint32_t table = Birth | (Survive << 9) | (static_cast<std::uint32_t>(N) << 18);	//the whole rule, also its identity
+
+	/**
+	 * the state of a cell in the next generation, without branching
+	 * @param alive is the cell alive now?
+	 * @param live_neighbors how many of its neighbors are alive
+	 * @return true if the cell will be alive
+	 */
+	static bool next(bool alive, int live_neighbors) {
+		return (table >> (live_neighbors + 9 * alive)) & 1;
+	}
+};
+
+template <unsigned Birth, unsigned Survive, Shape N>
+const int Rule<Birth, Survive, N>::neighbors;
+
+template <unsigned Birth, unsigned Survive, Shape N>
+const std::uint32_t Rule<Birth, Survive, N>::table;
+
+typedef Rule<counts(3), counts(2, 3)> ConwayRule;						//B3/S23
+typedef Rule<counts(1, 3), counts(1, 3), VON_NEUMANN> FredkinRule;		//B13/S13, orthogonal neighbors
+typedef Rule<counts(3, 6), counts(2, 3)> HighLifeRule;					//B36/S23
+typedef Rule<counts(2), counts()> SeedsRule;							//B2/S
+
 // 	------------------------------------------------------------------
 //	Class AbstractCell is the base class to FredkinCell and ConwayCell
 //	------------------------------------------------------------------
@@ -45,7 +165,14 @@ public:
 	 * @param neighbors the neighbors to the calling cell
 	 * @return the evolved cell
 	 */
-	virtual Cell evolve(const Cell neighbors[8]) const = 0;
+	virtual Cell evolve(const Neighborhood<Cell>& neighbors) const = 0;
+
+	/**
+	 * evolve the cell
+	 * @param neighbors the neighbors to the calling cell
+	 * @return the evolved cell
+	 */
+	Cell evolve(const Cell neighbors[8]) const;
 
 	/**
 	 * print this cell's symbol
@@ -54,12 +181,25 @@ public:
 	 */
 	virtual std::ostream& print(std::ostream& out) const = 0;
 
+	/**
+	 * the symbol this cell prints as
+	 * @return the symbol
+	 */
+	virtual char symbol() const = 0;
+
 	/**
 	 * clone this cell
 	 * @return a pointer to a clone of the cell
 	 */
 	virtual AbstractCell* clone() const = 0;
 
+	/**
+	 * clone this cell into storage the caller owns, no heap allocation
+	 * @param where storage big and aligned enough for the cell
+	 * @return a pointer to the clone, which lives at where
+	 */
+	virtual AbstractCell* clone(void* where) const = 0;
+
 	/**
 	 * destructor
 	 */
@@ -69,7 +209,7 @@ public:
 	 * constructor
 	 * @param border_ the value if the cell is a border or not
 	 */
-	AbstractCell(bool border_ = false) : border(border_) {}
+	AbstractCell(bool border_ = false) : alive(false), border(border_) {}
 
 	/**
 	 * is the cell alive or dead?
@@ -82,6 +222,13 @@ public:
 	 * @return true if border, false if not a border
 	 */
 	virtual const bool is_border() const { return border; }
+
+	/**
+	 * is rhs the same kind of cell with the same state?
+	 * @param rhs the cell to compare with
+	 * @return true if equal
+	 */
+	virtual bool equals(const AbstractCell& rhs) const = 0;
 };
 
 // 	---------------------------------------------------
@@ -96,6 +243,34 @@ class ConwayCell : public AbstractCell {
 	 */
 	friend ConwayCell operator+(const ConwayCell& old_cell, const ConwayCell neighbors[8]);
 
+	/**
+	 * evolve this cell, reading the neighbors in place
+	 * @param old_cell the cell to evolve
+	 * @param neighbors a view of the neighbors, same order as above
+	 * @return a new cell that's evolved from old_cell and neighbors
+	 */
+	friend ConwayCell operator+(const ConwayCell& old_cell, const Neighborhood<ConwayCell>& neighbors);
+
+	/**
+	 * do two cells have the same state?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return true if both are borders or both are alive or dead
+	 */
+	friend bool operator==(const ConwayCell& lhs, const ConwayCell& rhs) {
+		return lhs.border == rhs.border && (lhs.border || lhs.alive == rhs.alive);
+	}
+
+	/**
+	 * do two cells differ?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return the negation of ==
+	 */
+	friend bool operator!=(const ConwayCell& lhs, const ConwayCell& rhs) {
+		return !(lhs == rhs);
+	}
+
 public:
 
 	/**
@@ -117,18 +292,42 @@ public:
 	 */
 	std::ostream& print(std::ostream& out) const;
 
+	/**
+	 * the symbol this cell prints as
+	 * @return '*' if alive, '.' if dead
+	 */
+	char symbol() const final {
+		return alive ? '*' : '.';
+	}
+
+	using AbstractCell::evolve;
+
 	/**
 	 * evolve the cell
 	 * @param neighbors the neighbors to the calling cell
 	 * @return the evolved cell
 	 */
-	Cell evolve(const Cell neighbors[8]) const;
+	Cell evolve(const Neighborhood<Cell>& neighbors) const;
 
 	/**
 	 * preforms a deep copy on the cell
 	 * @return a pointer to the new cell
 	 */
 	ConwayCell* clone() const;
+
+	/**
+	 * preforms a deep copy on the cell into the given storage
+	 * @param where storage big and aligned enough for the cell
+	 * @return a pointer to the new cell
+	 */
+	ConwayCell* clone(void* where) const;
+
+	/**
+	 * is rhs a ConwayCell with the same state?
+	 * @param rhs the cell to compare with
+	 * @return true if equal
+	 */
+	bool equals(const AbstractCell& rhs) const;
 };
 
 // 	-----------------------------------------------------
@@ -143,13 +342,41 @@ class FredkinCell : public AbstractCell {
 	 */
 	friend FredkinCell operator+(const FredkinCell& old_cell, const FredkinCell neighbors[8]);
 
+	/**
+	 * evolve this cell, reading the neighbors in place
+	 * @param old_cell the cell to evolve
+	 * @param neighbors a view of the neighbors, same order as above
+	 * @return a new cell that's evolved from old_cell and neighbors
+	 */
+	friend FredkinCell operator+(const FredkinCell& old_cell, const Neighborhood<FredkinCell>& neighbors);
+
+	/**
+	 * do two cells have the same state and age?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return true if both are borders or both have the same state and age
+	 */
+	friend bool operator==(const FredkinCell& lhs, const FredkinCell& rhs) {
+		return lhs.border == rhs.border && (lhs.border || (lhs.alive == rhs.alive && lhs.age_ == rhs.age_));
+	}
+
+	/**
+	 * do two cells differ?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return the negation of ==
+	 */
+	friend bool operator!=(const FredkinCell& lhs, const FredkinCell& rhs) {
+		return !(lhs == rhs);
+	}
+
 public:
 
 	/**
 	 * constructor
 	 * @param border_ the value if the cell is a border or not
 	 */
-	FredkinCell(bool border_ = false) : AbstractCell(border_) {}
+	FredkinCell(bool border_ = false) : AbstractCell(border_), age_(0) {}
 
 	/**
 	 * constructor
@@ -171,12 +398,22 @@ public:
 	 */
 	std::ostream& print(std::ostream& out) const;
 
+	/**
+	 * the symbol this cell prints as
+	 * @return '-' if dead, the age if alive and younger than 10, '+' otherwise
+	 */
+	char symbol() const final {
+		return !alive ? '-' : (age_ < 10 ? static_cast<char>('0' + age_) : '+');
+	}
+
+	using AbstractCell::evolve;
+
 	/**
 	 * evolve the cell
 	 * @param neighbors the neighbors to the calling cell
 	 * @return the evolved cell
 	 */
-	Cell evolve(const Cell neighbors[8]) const;
+	Cell evolve(const Neighborhood<Cell>& neighbors) const;
 
 	/**
 	 * preforms a deep copy on the cell
@@ -184,6 +421,20 @@ public:
 	 */
 	FredkinCell* clone() const;
 
+	/**
+	 * preforms a deep copy on the cell into the given storage
+	 * @param where storage big and aligned enough for the cell
+	 * @return a pointer to the new cell
+	 */
+	FredkinCell* clone(void* where) const;
+
+	/**
+	 * is rhs a FredkinCell with the same state and age?
+	 * @param rhs the cell to compare with
+	 * @return true if equal
+	 */
+	bool equals(const AbstractCell& rhs) const;
+
 	/**
 	 * what is the age of the fredkincell?
 	 * @return the age of the fredkincell
@@ -206,12 +457,20 @@ class Cell {
 	 */
 	friend Cell operator+(const Cell& old_cell, const Cell neigbors[8]);
 
+	/**
+	 * evolve this cell, reading the neighbors in place, works for all cells
+	 * @param old_cell the cell to evolve
+	 * @param neighbors a view of the neighbors, same order as above
+	 * @return a new cell that's evolved from old_cell and neighbors
+	 */
+	friend Cell operator+(const Cell& old_cell, const Neighborhood<Cell>& neighbors);
+
 	/**
 	 * print this cell's symbol, works for all cells
 	 * @param out the ostream to write to
 	 * @return the ostream
 	 */
-	friend std::ostream& operator<<(std::ostream& out, const Cell c);
+	friend std::ostream& operator<<(std::ostream& out, const Cell& c);
 
 	/**
 	 * read a symbol to a cell, works for all cells
@@ -221,26 +480,42 @@ class Cell {
 	 */
 	friend std::istream& operator>>(std::istream& in, Cell& c);
 
+	/**
+	 * do two cells have the same kind and state?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return true if the encapsulated cells are equal
+	 */
+	friend bool operator==(const Cell& lhs, const Cell& rhs);
+
+	/**
+	 * do two cells differ in kind or state?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return the negation of ==
+	 */
+	friend bool operator!=(const Cell& lhs, const Cell& rhs);
+
 public:
-	AbstractCell *acell;		//pointer to the cell object encapsulated by the Cell class
+	AbstractCell *acell;		//pointer to the cell object encapsulated by the Cell class, normally into storage
 
 	/**
-	 * constructor
+	 * constructor, takes ownership of a heap allocated cell
 	 * @param c the cell to be encapsulated, assigned to variable acell
 	 */
 	Cell(AbstractCell* c = nullptr) : acell(c) {}
 
 	/**
 	 * constructor
-	 * @param c the cell to be encapsulated, assigned to variable acell
+	 * @param c the cell to be encapsulated, copied into storage
 	 */
-	Cell(const AbstractCell& c) : acell(c.clone()) {}
+	Cell(const AbstractCell& c) : acell(c.clone(&storage)) {}
 
 	/**
 	 * constructor
 	 * @param border_ the value if the cell is a border or not
 	 */
-	Cell(bool border_) : acell(new ConwayCell(border_)) {}
+	Cell(bool border_) : acell(new (&storage) ConwayCell(border_)) {}
 
 	/**
 	 * constructor
@@ -260,7 +535,7 @@ public:
 	~Cell();
 
 	/**
-	 * will call clone on this cell with the parameter rhs
+	 * will release this cell and clone rhs into its storage
 	 * @param rhs the right hand side side to be copied from
 	 * @return a pointer this
 	 */
@@ -272,315 +547,3721 @@ public:
 	 */
 	bool is_alive() const;
 	bool is_border() const;
-};
-
-// 	----------------------------------------------------
-//	Generic Class Life has the board to the game of life
-//	----------------------------------------------------
-template <class T>
-class Life {
-public:
 
 	/**
-	 * constructor
-	 * @param in the istream to read from
-	 * @param h is the height of the board (without borders as they are hidden from the user)
-	 * @param w is the width of the board (without borders as they are hidden from the user)
-	 */	
-	Life(std::istream& in, int h, int w) {
-		width = w;
-		height = h;
-		generation = 0;
-		population = 0;
-
-		int x = 0;
-		int y = 0;
+	 * the symbol the encapsulated cell prints as
+	 * @return the symbol
+	 */
+	char symbol() const;
 
-		board.resize((width + 2) * (height + 2), T(true)); // initialize board, fill it with borders
+private:
+	/**
+	 * does acell point into storage, rather than to a cell on the heap?
+	 * @return true if the cell lives inside this Cell
+	 */
+	bool is_inline() const;
 
-		while (true) {
-			int input = in.get();
+	/**
+	 * destroy the encapsulated cell, in place or on the heap
+	 */
+	void release();
 
-			if (input == EOF || (input == '\n' && y == 0))
-				break;
+	static const std::size_t storage_size = sizeof(ConwayCell) > sizeof(FredkinCell) ? sizeof(ConwayCell) : sizeof(FredkinCell);
+	static const std::size_t storage_align = alignof(ConwayCell) > alignof(FredkinCell) ? alignof(ConwayCell) : alignof(FredkinCell);
 
-			if (input == '\n') {
-				x++;
-				assert(y == width);
-				y = 0;
-				continue;
-			}
+	std::aligned_storage<storage_size, storage_align>::type storage;	//the encapsulated cell lives here
+};
 
-			// Add the actual cell
-			T new_cell = T((char) input);
+// 	-------------------------------------------------------------------------
+//	Generic Class RuleCell is a cell that plays by Rule R, without any virtual
+//	dispatch. An Aging cell counts the generations it survived and prints like
+//	a FredkinCell, otherwise it prints like a ConwayCell
+// 	-------------------------------------------------------------------------
+template <class R, bool Aging = false>
+class RuleCell {
+	/**
+	 * evolve this cell, reading the neighbors in place
+	 * @param old_cell the cell to evolve
+	 * @param neighbors a view of the neighbors, in the order documented on AbstractCell
+	 * @return a new cell that's evolved from old_cell and neighbors
+	 */
+	friend RuleCell operator+(const RuleCell& old_cell, const Neighborhood<RuleCell>& neighbors) {
+		int live_neighbors = 0;
+		for (int i = 0; i < R::neighbors; i++)
+			live_neighbors += neighbors[i].alive;	// borders are never alive
 
-			if (new_cell.is_alive())
-				population++;
+		const bool alive = R::next(old_cell.alive, live_neighbors);
+		return RuleCell(old_cell.age_ + (Aging && old_cell.alive && alive), alive);
+	}
 
-			at(x, y).~T();	// deallocate
-			at(x, y) = new_cell;
+	/**
+	 * evolve this cell
+	 * @param old_cell the cell to evolve
+	 * @param neighbors the 8 neighbors, in the order documented on AbstractCell
+	 * @return a new cell that's evolved from old_cell and neighbors
+	 */
+	friend RuleCell operator+(const RuleCell& old_cell, const RuleCell neighbors[8]) {
+		return old_cell + Neighborhood<RuleCell>(neighbors);
+	}
 
-			y++;
-		}
+	/**
+	 * do two cells have the same state and age?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return true if equal
+	 */
+	friend bool operator==(const RuleCell& lhs, const RuleCell& rhs) {
+		return lhs.border == rhs.border && lhs.alive == rhs.alive && lhs.age_ == rhs.age_;
+	}
 
-		assert(x == height);
+	/**
+	 * do two cells differ?
+	 * @param lhs the left hand side
+	 * @param rhs the right hand side
+	 * @return the negation of ==
+	 */
+	friend bool operator!=(const RuleCell& lhs, const RuleCell& rhs) {
+		return !(lhs == rhs);
 	}
 
 	/**
-	 * print this cell's symbol, works for all cells
+	 * print a cell's symbol
 	 * @param out the ostream to write to
+	 * @param c the cell we want to print
+	 * @return the ostream
 	 */
-	void print(std::ostream& out) {
-		out << "Generation = " << generation << ", Population = " << population << "." << std::endl;
-		for (int x = 1; x < height + 1; x++) {
-			for (int y = 1; y < width + 1; y++) {
-				const T cell = board[x * (width + 2) + y];
+	friend std::ostream& operator<<(std::ostream& out, const RuleCell& c) {
+		return out << c.symbol();
+	}
 
-				out << cell;
-			}
+public:
+
+	/**
+	 * constructor
+	 * @param border_ the value if the cell is a border or not
+	 */
+	RuleCell(bool border_ = false) : alive(false), border(border_), age_(0) {}
 
-			out << std::endl;
+	/**
+	 * constructor
+	 * @param input the character representation of a cell, '*' or '.', or
+	 *        for an aging cell '-', a digit or '+'
+	 */
+	RuleCell(const char& input) : border(false) {
+		if (Aging) {
+			alive = input != '-';
+			age_ = (input >= '0' && input <= '9') ? input - '0' : (input == '+' ? 10 : 0);
+		} else {
+			assert(input == '*' || input == '.');
+			alive = input == '*';
+			age_ = 0;
 		}
-		out << std::endl;
 	}
 
 	/**
-	 * will call the function evolve on the whole cell
+	 * constructor
+	 * @param a the age of the cell, kept at 0 unless Aging
+	 * @param alive_ is the cell alive?
 	 */
-	void evolve_all() {
-		population = 0;
+	RuleCell(int a, bool alive_) : alive(alive_), border(false), age_(Aging ? a : 0) {}
 
-		std::vector<T> temp_board = board;
-
-		for (int x = 0; x < height; x++) {
-			for (int y = 0; y < width; y++) {
-				const T& cell = at(x, y);
-
-				T neighbors[8] = {
-					temp_board[(x + 1) * (width + 2) + y],		// up
-					temp_board[(x + 2) * (width + 2) + y + 1],	// right
-					temp_board[(x + 1) * (width + 2) + y + 2],	// down
-					temp_board[(x) * (width + 2) + y + 1],		// left
-					temp_board[(x + 2) * (width + 2) + y],		// top-right
-					temp_board[(x + 2) * (width + 2) + y + 2],	// bottom-right
-					temp_board[(x) * (width + 2) + y + 2],		// bottom-left
-					temp_board[(x) * (width + 2) + y]};			// top-left
-
-				T new_cell = cell + neighbors;
-				
-				if (new_cell.is_alive())
-					population++;
-				
-				at(x, y).~T();		// deallocate old cell to avoid memory leaks
-				at(x, y) = new_cell;
-			}
-		}
+	/**
+	 * is the cell alive or dead?
+	 * @return true if alive, false if dead
+	 */
+	bool is_alive() const { return alive; }
 
-		generation++;
-	}
+	/**
+	 * is the cell a border?
+	 * @return true if border, false if not a border
+	 */
+	bool is_border() const { return border; }
 
 	/**
-	 * will retrieve the cell at position (x, y) in the board
-	 * @param x the horizontal variable (without borders as they are hidden from the user)
-	 * @param y the vertical variable (without borders as they are hidden from the user)
-	 * @return the cell at position (x,y)
-	 */	
-	T& at(int x, int y) {
-		return board.at((x + 1) * (width + 2) + y + 1);
-	}
+	 * how many generations has the cell survived?
+	 * @return the age, always 0 unless Aging
+	 */
+	int age() const { return age_; }
 
 	/**
-	 * const version of at(), will retrieve the cell at position (x, y) in the board
-	 * @param x the horizontal variable (without borders as they are hidden from the user)
-	 * @param y the vertical variable (without borders as they are hidden from the user)
-	 * @return the cell at position (x,y)
-	 */	
-	const T& at(int x, int y) const {
-		return board.at((x + 1) * (width + 2) + y + 1);
+	 * the symbol this cell prints as
+	 * @return the symbol
+	 */
+	char symbol() const {
+		if (!Aging)
+			return alive ? '*' : '.';
+		return !alive ? '-' : (age_ < 10 ? static_cast<char>('0' + age_) : '+');
 	}
 
-	// 	-------------------------------------------------
-	//	Nested Class iterator, it will iterate over board
-	//	-------------------------------------------------
-	template <class T2>
-	class iterator {
-	public:
+private:
+	bool alive;		//is the cell alive?
+	bool border;	//is the cell a border?
+	int age_;		//generations survived, 0 unless Aging
+};
 
-		/**
-		 * constructor
-	 	 * @param l is the life instance to iterate over
-	 	 * @param x the horizontal variable (without borders as they are hidden from the user)
-	 	 * @param y the vertical variable (without borders as they are hidden from the user)
-		 */	
-		iterator(Life& l, int x_, int y_) : life(l), x(x_), y(y_) {}
+typedef RuleCell<ConwayRule> ConwayRuleCell;			//plays and prints like ConwayCell
+typedef RuleCell<FredkinRule, true> FredkinRuleCell;	//plays and prints like FredkinCell
+typedef RuleCell<HighLifeRule> HighLifeCell;
+typedef RuleCell<SeedsRule> SeedsCell;
 
-		/**
-		 * operator * will override the * operator for iterator
-	 	 * @return a reference to the cell this iterator points to
-		 */	
-		T2& operator*() const {
-			return life.at(x, y);
-		}
+// 	-------------------------------------------------------------------------
+//	Struct CellTraits describes a kind of cell to boards that need more than
+//	the cell itself offers
+// 	-------------------------------------------------------------------------
+template <class T>
+struct CellTraits;
 
-		/**
-		 * operator ++ will override the ++ operator for iterator and will iterate to the next element 
-	 	 * @return a reference to the iterator pointing to the next element
-		 */	
-		iterator<T2>& operator++() {
-			y++;
-			if (y >= life.width) {
-				x++;
-				y = 0;
-			}
-			return *this;
-		}
+//	species of a single cell, as stored in a snapshot
+const std::uint8_t CONWAY = 0;
+const std::uint8_t FREDKIN = 1;
 
-		/**
-		 * operator -- will override the -- operator for iterator and will iterate to the previous element 
-	 	 * @return a reference to the iterator pointing to the previous element
-		 */	
-		iterator<T2>& operator--() {
-			y--;
-			if (y < 0) {
-				x--;
-				y = life.width - 1;
-			}
-			return *this;
-		}
+//	type of a whole board, as stored in a snapshot header
+const std::uint32_t CONWAY_BOARD = 1;
+const std::uint32_t FREDKIN_BOARD = 2;
+const std::uint32_t CELL_BOARD = 3;
 
-		/**
-		 * operator == will override the == operator for iterator
-	 	 * @return a bool with the value of the comparison
-		 */	
-		bool operator==(const iterator<T2>& rhs) const {
-			return x == rhs.x && y == rhs.y && &life == &rhs.life;
-		}
+template <>
+struct CellTraits<ConwayCell> {
+	/**
+	 * the symbol of the cell that fills empty space
+	 * @return the symbol
+	 */
+	static char dead() { return '.'; }
 
-		/**
+	/**
+	 * the tag a snapshot of a board of these cells carries
+	 * @return the tag
+	 */
+	static std::uint32_t type() { return CONWAY_BOARD; }
+
+	/**
+	 * @param c the cell
+	 * @return the species of c
+	 */
+	static std::uint8_t species(const ConwayCell&) { return CONWAY; }
+
+	/**
+	 * @param c the cell
+	 * @return the age of c, always 0
+	 */
+	static int age(const ConwayCell&) { return 0; }
+
+	/**
+	 * build a cell from its parts in a snapshot
+	 * @param species the species, must be CONWAY
+	 * @param alive is the cell alive?
+	 * @param age ignored
+	 * @return the cell
+	 */
+	static ConwayCell make(std::uint8_t species, bool alive, int) {
+		assert(species == CONWAY);
+		return ConwayCell(alive ? '*' : '.');
+	}
+};
+
+template <>
+struct CellTraits<FredkinCell> {
+	/**
+	 * the symbol of the cell that fills empty space
+	 * @return the symbol
+	 */
+	static char dead() { return '-'; }
+
+	/**
+	 * the tag a snapshot of a board of these cells carries
+	 * @return the tag
+	 */
+	static std::uint32_t type() { return FREDKIN_BOARD; }
+
+	/**
+	 * @param c the cell
+	 * @return the species of c
+	 */
+	static std::uint8_t species(const FredkinCell&) { return FREDKIN; }
+
+	/**
+	 * @param c the cell
+	 * @return the age of c
+	 */
+	static int age(const FredkinCell& c) { return c.age(); }
+
+	/**
+	 * build a cell from its parts in a snapshot
+	 * @param species the species, must be FREDKIN
+	 * @param alive is the cell alive?
+	 * @param age the age of the cell
+	 * @return the cell
+	 */
+	static FredkinCell make(std::uint8_t species, bool alive, int age) {
+		assert(species == FREDKIN);
+		return FredkinCell(age, alive);
+	}
+};
+
+template <>
+struct CellTraits<Cell> {
+	/**
+	 * the symbol of the cell that fills empty space
+	 * @return the symbol
+	 */
+	static char dead() { return '.'; }
+
+	/**
+	 * the tag a snapshot of a board of these cells carries
+	 * @return the tag
+	 */
+	static std::uint32_t type() { return CELL_BOARD; }
+
+	/**
+	 * @param c the cell
+	 * @return the species of the encapsulated cell
+	 */
+	static std::uint8_t species(const Cell& c) {
+		return dynamic_cast<const FredkinCell*>(c.acell) != nullptr ? FREDKIN : CONWAY;
+	}
+
+	/**
+	 * @param c the cell
+	 * @return the age of the encapsulated cell, 0 for a conway cell
+	 */
+	static int age(const Cell& c) {
+		const FredkinCell* f = dynamic_cast<const FredkinCell*>(c.acell);
+		return f != nullptr ? f->age() : 0;
+	}
+
+	/**
+	 * build a cell from its parts in a snapshot
+	 * @param species the species
+	 * @param alive is the cell alive?
+	 * @param age the age of the cell, ignored for a conway cell
+	 * @return the cell
+	 */
+	static Cell make(std::uint8_t species, bool alive, int age) {
+		if (species == FREDKIN)
+			return Cell(FredkinCell(age, alive));
+		return Cell(ConwayCell(alive ? '*' : '.'));
+	}
+};
+
+template <class R, bool Aging>
+struct CellTraits<RuleCell<R, Aging> > {
+	/**
+	 * the symbol of the cell that fills empty space
+	 * @return the symbol
+	 */
+	static char dead() { return Aging ? '-' : '.'; }
+
+	/**
+	 * the tag a snapshot of a board of these cells carries, different for
+	 * every rule
+	 * @return the tag
+	 */
+	static std::uint32_t type() { return 0x80000000u | (R::table << 1) | Aging; }
+
+	/**
+	 * @param c the cell
+	 * @return FREDKIN for an aging cell, CONWAY otherwise
+	 */
+	static std::uint8_t species(const RuleCell<R, Aging>&) { return Aging ? FREDKIN : CONWAY; }
+
+	/**
+	 * @param c the cell
+	 * @return the age of c
+	 */
+	static int age(const RuleCell<R, Aging>& c) { return c.age(); }
+
+	/**
+	 * build a cell from its parts in a snapshot
+	 * @param species ignored
+	 * @param alive is the cell alive?
+	 * @param age the age of the cell
+	 * @return the cell
+	 */
+	static RuleCell<R, Aging> make(std::uint8_t, bool alive, int age) {
+		return RuleCell<R, Aging>(age, alive);
+	}
+};
+
+// 	-------------------------------------------------------------------------
+//	Class WorkerPool keeps threads alive between generations and hands them
+//	numbered tasks, the thread that calls run() works on tasks as well
+// 	-------------------------------------------------------------------------
+class WorkerPool {
+public:
+
+	/**
+	 * constructor
+	 * @param threads the number of threads that work on tasks, including the caller of run()
+	 */
+	explicit WorkerPool(int threads);
+
+	/**
+	 * destructor, stops and joins the workers
+	 */
+	~WorkerPool();
+
+	/**
+	 * run task(0) ... task(tasks - 1) on the pool and wait for all of them
+	 * @param tasks the number of tasks
+	 * @param task the function to call with the index of every task
+	 */
+	void run(int tasks, const std::function<void(int)>& task);
+
+	/**
+	 * how many threads work on tasks?
+	 * @return the number of threads, including the caller of run()
+	 */
+	int size() const;
+
+private:
+	WorkerPool(const WorkerPool&);
+	WorkerPool& operator=(const WorkerPool&);
+
+	/**
+	 * the loop every worker thread runs until the pool is destroyed
+	 */
+	void work();
+
+	std::vector<std::thread> workers;	//the threads, not counting the caller of run()
+	std::mutex lock;					//guards everything below
+	std::condition_variable wake;		//signaled when tasks are posted or the pool stops
+	std::condition_variable done;		//signaled when the last task finishes
+
+	const std::function<void(int)>* job;	//the task being run
+	int tasks;			//number of tasks posted
+	int next_task;		//next task nobody took yet
+	int remaining;		//tasks not finished yet
+	bool stopping;		//true when the workers should exit
+};
+
+// 	-------------------------------------------------------------------------
+//	Class WorkStealingPool runs independent tasks of uneven size. Every thread
+//	starts with its own deque of tasks, takes them from the back, and once it
+//	runs dry steals from the front of the others
+// 	-------------------------------------------------------------------------
+class WorkStealingPool {
+public:
+
+	/**
+	 * constructor
+	 * @param threads the number of threads that work on tasks, including the caller of run()
+	 */
+	explicit WorkStealingPool(int threads);
+
+	/**
+	 * run task(0) ... task(tasks - 1) and wait for all of them, the threads
+	 * live only as long as the call. If tasks throw, the first exception is
+	 * rethrown once every thread stopped
+	 * @param tasks the number of tasks
+	 * @param task the function to call with the index of every task
+	 */
+	void run(int tasks, const std::function<void(int)>& task);
+
+	/**
+	 * how many threads work on tasks?
+	 * @return the number of threads, including the caller of run()
+	 */
+	int size() const;
+
+private:
+	WorkStealingPool(const WorkStealingPool&);
+	WorkStealingPool& operator=(const WorkStealingPool&);
+
+	struct Queue {
+		std::mutex lock;			//guards tasks
+		std::deque<int> tasks;		//tasks not taken yet
+	};
+
+	/**
+	 * take a task, from the back of the thread's own queue or else from the
+	 * front of another
+	 * @param self the index of the thread
+	 * @param task set to the task taken
+	 * @return false once every queue is empty
+	 */
+	bool take(int self, int& task);
+
+	/**
+	 * run tasks until there are none left
+	 * @param self the index of the thread
+	 * @param task the function to call with the index of every task
+	 */
+	void work(int self, const std::function<void(int)>& task);
+
+	int threads;									//threads working, including the caller
+	std::vector<std::unique_ptr<Queue> > queues;	//one per thread
+	std::mutex error_lock;							//guards error
+	std::exception_ptr error;						//the first exception a task threw
+};
+
+// 	-------------------------------------------------------------------------
+//	Class FrameWriter writes frames to an ostream on a thread of its own, so
+//	whoever produces them never waits for the output unless too many frames
+//	are already waiting
+// 	-------------------------------------------------------------------------
+class FrameWriter {
+public:
+
+	/**
+	 * constructor, starts the writer thread
+	 * @param out the ostream to write to, only the writer thread touches it until finish()
+	 * @param limit how many frames may wait before push() blocks
+	 */
+	FrameWriter(std::ostream& out, std::size_t limit);
+
+	/**
+	 * destructor, finishes
+	 */
+	~FrameWriter();
+
+	/**
+	 * queue a frame behind the others, blocks while limit frames are waiting
+	 * @param frame the frame, taken over and replaced by a buffer that was
+	 *        written out already, so the caller can render into it again
+	 */
+	void push(std::string& frame);
+
+	/**
+	 * wait until every frame is written, then flush out and stop the thread
+	 */
+	void finish();
+
+private:
+	FrameWriter(const FrameWriter&);
+	FrameWriter& operator=(const FrameWriter&);
+
+	/**
+	 * the loop the writer thread runs until finish()
+	 */
+	void work();
+
+	std::ostream& out;					//where the frames go
+	std::size_t limit;					//frames that may wait
+	std::mutex lock;					//guards everything below
+	std::condition_variable changed;	//signaled when a frame is queued or written, or on finish()
+	std::deque<std::string> frames;		//frames waiting, oldest first
+	std::vector<std::string> spare;		//buffers already written, handed back by push()
+	bool finishing;						//true once finish() was called
+	std::thread writer;					//writes the frames
+};
+
+//	what kind of cells a LifeJob plays with
+enum CellKind {
+	CONWAY_CELLS,		//Life<ConwayCell>
+	FREDKIN_CELLS,		//Life<FredkinCell>
+	MIXED_CELLS			//Life<Cell>
+};
+
+// 	-------------------------------------------------------------------------
+//	Struct LifeJob is one independent simulation for run_batch()
+// 	-------------------------------------------------------------------------
+struct LifeJob {
+
+	/**
+	 * constructor
+	 * @param c what kind of cells the board holds
+	 * @param b the board, as text or a snapshot
+	 * @param g the generation to evolve up to
+	 * @param p the generations to print, in increasing order, none prints only g
+	 * @param t text written before the first board
+	 */
+	LifeJob(CellKind c, const std::string& b, int g, const std::vector<int>& p = std::vector<int>(), const std::string& t = "") :
+		cells(c), board(b), generations(g), prints(p), title(t), cycle_history(0) {}
+
+	CellKind cells;				//what kind of cells the board holds
+	std::string board;			//the board, as text or a snapshot
+	int generations;			//the generation to evolve up to, nothing past the last print is observable
+	std::vector<int> prints;	//the generations to print, in increasing order, none prints only the last
+	std::string title;			//text written before the first board
+	int cycle_history;			//passed to Life::set_cycle_detection(), 0 by default
+};
+
+/**
+ * run one job on the calling thread
+ * @param job the job
+ * @return its title and every board it printed, same bytes as Life::print()
+ */
+std::string run_job(const LifeJob& job);
+
+/**
+ * run many jobs across threads, a work stealing pool keeps the threads busy
+ * however uneven the jobs are
+ * @param jobs the jobs
+ * @param threads the number of threads, including the caller
+ * @return the output of every job, in the order of jobs
+ */
+std::vector<std::string> run_batch(const std::vector<LifeJob>& jobs, int threads);
+
+/**
+ * run many jobs across threads and write their output in the order of jobs,
+ * the same bytes as running them one after another, a FrameWriter writes
+ * each job's output once the jobs before it are done
+ * @param jobs the jobs
+ * @param threads the number of threads, including the caller
+ * @param out the ostream to write to
+ */
+void run_batch(const std::vector<LifeJob>& jobs, int threads, std::ostream& out);
+
+/**
+ * size a frame buffer for a board and write everything but the cells: the
+ * header, the newline after every row and the blank line that ends the frame
+ * @param frame the buffer, reused from frame to frame
+ * @param generation the generation in the header
+ * @param population the population in the header
+ * @param h the height of the board
+ * @param w the width of the board
+ * @return where the first row goes, row x starts at x * (w + 1)
+ */
+char* begin_frame(std::string& frame, unsigned long long generation, unsigned long long population, int h, int w);
+
+/**
+ * write all of a buffer to a file descriptor, throws std::runtime_error on failure
+ * @param fd the file descriptor
+ * @param data the buffer
+ */
+void write_all(int fd, const std::string& data);
+
+/**
+ * write all of a buffer to a file descriptor, throws std::runtime_error on failure
+ * @param fd the file descriptor
+ * @param data the first byte of the buffer
+ * @param size the number of bytes
+ */
+void write_all(int fd, const char* data, std::size_t size);
+
+#ifdef LIFE_STATS
+// 	-------------------------------------------------------------------------
+//	Struct LifeStats counts what one call to Life::evolve_all() did, only
+//	built with -DLIFE_STATS
+// 	-------------------------------------------------------------------------
+struct LifeStats {
+	int generation;					//the generation evolved into
+	double seconds;					//wall time of evolve_all()
+	long long evaluated;			//cells evolved, fewer than the board when tiled
+	long long changed;				//cells that differ from the last generation
+	long long births;				//dead cells that came alive
+	long long deaths;				//live cells that died
+	long long ages[11];				//live fredkin cells of age 0 to 9, then 10 and older
+	unsigned long long clones;		//cells cloned, in place or on the heap
+	unsigned long long allocations;	//cells cloned on the heap
+};
+
+/**
+ * @return the cells cloned so far on the calling thread, in place or on the heap
+ */
+unsigned long long cell_clones();
+
+/**
+ * @return the cells cloned on the heap so far on the calling thread
+ */
+unsigned long long cell_allocations();
+#endif
+
+// 	-------------------------------------------------------------------------
+//	Struct SnapshotHeader starts a binary snapshot of a board. It is followed,
+//	at 8 byte aligned offsets, by the alive bits packed 64 to a word in row
+//	order, then an int32 age per cell unless the board is all conway cells,
+//	then a species byte per cell if the board mixes species. Everything is in
+//	the byte order of the machine that wrote it, byte_order tells.
+// 	-------------------------------------------------------------------------
+struct SnapshotHeader {
+	char magic[4];					//"\x89LIF", never the start of a text board
+	std::uint32_t version;			//format version
+	std::uint32_t byte_order;		//0x01020304 as written
+	std::uint32_t type;				//CellTraits<T>::type() of the board
+	std::uint32_t height;			//height of the board
+	std::uint32_t width;			//width of the board
+	std::uint64_t generation;		//generation of the board
+	std::uint64_t population;		//population of the board
+};
+
+// 	-------------------------------------------------------------------------
+//	Struct SnapshotLayout tells where each part of a snapshot starts
+// 	-------------------------------------------------------------------------
+struct SnapshotLayout {
+	std::size_t bits;		//offset of the alive bits
+	std::size_t ages;		//offset of the ages, 0 if there are none
+	std::size_t species;	//offset of the species, 0 if there are none
+	std::size_t size;		//size of the whole snapshot
+};
+
+/**
+ * a header for a snapshot of a board
+ * @param type CellTraits<T>::type() of the board
+ * @param h the height of the board
+ * @param w the width of the board
+ * @param generation the generation of the board
+ * @param population the population of the board
+ * @return the header
+ */
+SnapshotHeader make_snapshot_header(std::uint32_t type, int h, int w, unsigned long long generation, unsigned long long population);
+
+/**
+ * where each part of a snapshot goes
+ * @param header the header of the snapshot, made by make_snapshot_header()
+ * or checked by read_snapshot_header() so the sizes cannot overflow
+ * @return the layout
+ */
+SnapshotLayout snapshot_layout(const SnapshotHeader& header);
+
+/**
+ * does the memory hold a snapshot rather than a text board?
+ * @param first the first byte
+ * @param last one past the last byte
+ * @return true if it starts with the snapshot magic
+ */
+bool is_snapshot(const char* first, const char* last);
+
+/**
+ * read and check the header of a snapshot, throws std::runtime_error if the
+ * snapshot is cut short, from another format or byte order, or of another
+ * type of board
+ * @param first the first byte
+ * @param last one past the last byte
+ * @param type CellTraits<T>::type() of the board being restored
+ * @return the header
+ */
+SnapshotHeader read_snapshot_header(const char* first, const char* last, std::uint32_t type);
+
+/**
+ * write a file whole, through a temporary file that is renamed over path so a
+ * crash never leaves half a file behind, throws std::runtime_error on failure.
+ * Every call gets a temporary file of its own, so concurrent writes of the
+ * same path each leave a whole file, the last one renamed wins
+ * @param path the file to write
+ * @param data the contents
+ */
+void write_file(const std::string& path, const std::string& data);
+
+/**
+ * write a file the way print() writes a frame, from rows already written to
+ * another file, which is removed. Like write_file() the file is replaced
+ * only once it is complete. Throws std::runtime_error on failure
+ * @param path the file to write
+ * @param rows the file with the rows of the frame, each ended by '\n'
+ * @param generation the generation in the header
+ * @param population the population in the header
+ */
+void write_frame_file(const std::string& path, const std::string& rows, unsigned long long generation, unsigned long long population);
+
+//	how print_delta() writes the changes of a board
+enum DeltaFormat {DELTA_TEXT, DELTA_BINARY};
+
+// 	-------------------------------------------------------------------------
+//	Struct DeltaRecord is one cell that changed between two deltas. kind is
+//	'B' for a birth, 'D' for a death and 'A' for a cell that stayed alive or
+//	dead but changed its age or species
+// 	-------------------------------------------------------------------------
+struct DeltaRecord {
+	std::int32_t x;		//row of the cell
+	std::int32_t y;		//column of the cell
+	std::int32_t age;	//new age of the cell, 0 for a conway cell
+	char kind;			//'B', 'D' or 'A'
+	char symbol;		//new symbol of the cell
+	char padding[2];	//keeps the binary record 16 bytes, always 0
+};
+
+/**
+ * append the start of a delta stream to a buffer: the size of the board and
+ * every cell of the first frame. A text stream starts with "Delta h w" and
+ * the frame the way print() writes it
+ * @param out the buffer
+ * @param format text or binary
+ * @param generation the generation of the frame
+ * @param population the population of the frame
+ * @param h the height of the board
+ * @param w the width of the board
+ * @param rows the symbols of the frame, row x starting at x * (w + 1)
+ */
+void append_delta_keyframe(std::string& out, DeltaFormat format, unsigned long long generation, unsigned long long population, int h, int w, const char* rows);
+
+/**
+ * append the changes of one generation to a buffer. A text delta is a line
+ * "Generation = g, Population = p, Changes = n.", a line
+ * "kind x y symbol age" per change and a blank line
+ * @param out the buffer
+ * @param format text or binary
+ * @param generation the generation after the changes
+ * @param population the population after the changes
+ * @param changes the cells that changed
+ */
+void append_delta(std::string& out, DeltaFormat format, unsigned long long generation, unsigned long long population, const std::vector<DeltaRecord>& changes);
+
+// 	-------------------------------------------------------------------------
+//	Class DeltaReader reads a stream written by print_delta(), in either
+//	format, and rebuilds the frame print() would have written for every
+//	generation in it
+// 	-------------------------------------------------------------------------
+class DeltaReader {
+public:
+
+	/**
+	 * constructor
+	 * @param in the stream to read from
+	 */
+	explicit DeltaReader(std::istream& in);
+
+	/**
+	 * read the next generation of the stream, the first frame on the first
+	 * call, throws std::runtime_error if the stream is malformed
+	 * @return false at the end of the stream
+	 */
+	bool next();
+
+	/**
+	 * the frame of the generation read last, built when asked for
+	 * @return the frame, the way print() writes it
+	 */
+	const std::string& frame();
+
+	/**
+	 * @return the cells that changed in the generation read last, empty for the first frame
+	 */
+	const std::vector<DeltaRecord>& changes() const;
+
+	/**
+	 * @return the generation read last
+	 */
+	unsigned long long generation() const;
+
+	/**
+	 * @return the population of the generation read last
+	 */
+	unsigned long long population() const;
+
+private:
+	/**
+	 * read exactly n bytes, throws std::runtime_error if the stream ends first
+	 */
+	void read_bytes(void* p, std::size_t n);
+
+	/**
+	 * read n elements into out a chunk at a time, so a count the stream cannot
+	 * back throws std::runtime_error before anything near n is allocated
+	 */
+	template <class C>
+	void read_elements(C& out, std::size_t n) {
+		typedef typename C::value_type V;
+		const std::size_t chunk = (1 << 16) / sizeof(V);
+
+		out.clear();
+		while (out.size() < n) {
+			const std::size_t done = out.size();
+			out.resize(done + std::min(chunk, n - done));
+			read_bytes(&out[done], (out.size() - done) * sizeof(V));
+		}
+	}
+
+	std::istream& in;						//the stream read from
+	bool started;							//has the first frame been read?
+	int height;								//height of the board
+	int width;								//width of the board
+	unsigned long long last_generation;		//generation read last
+	unsigned long long last_population;		//population of the generation read last
+	std::string symbols;					//every cell of the board, row by row
+	std::vector<DeltaRecord> records;		//changes read last
+	std::string rendered;					//the last frame built
+	bool stale;								//has a generation been read since rendered was built?
+};
+
+// 	-------------------------------------------------------------------------
+//	Class MappedFile maps a whole file read-only into memory
+// 	-------------------------------------------------------------------------
+class MappedFile {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if the file cannot be mapped
+	 * @param path the file to map
+	 */
+	explicit MappedFile(const std::string& path);
+
+	/**
+	 * destructor, unmaps the file
+	 */
+	~MappedFile();
+
+	/**
+	 * the contents of the file
+	 * @return a pointer to the first byte
+	 */
+	const char* data() const;
+
+	/**
+	 * the size of the file
+	 * @return the number of bytes
+	 */
+	std::size_t size() const;
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char* bytes;		//the mapping, null for an empty file
+	std::size_t length;		//the size of the file
+};
+
+// 	-------------------------------------------------------------------------
+//	Struct SharedCell is a cell as it crosses from one process to another,
+//	taken apart and put back together with CellTraits
+// 	-------------------------------------------------------------------------
+struct SharedCell {
+	std::int32_t age;		//age of the cell, 0 for a conway cell
+	std::uint8_t species;	//CONWAY or FREDKIN
+	std::uint8_t alive;		//1 if the cell is alive
+};
+
+// 	-------------------------------------------------------------------------
+//	Class SharedMemory is a POSIX shared memory segment mapped read-write, the
+//	mapping is inherited by processes forked after it is made
+// 	-------------------------------------------------------------------------
+class SharedMemory {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if the segment cannot be made
+	 * @param size the number of bytes, zero filled
+	 */
+	explicit SharedMemory(std::size_t size);
+
+	/**
+	 * destructor, unmaps the segment
+	 */
+	~SharedMemory();
+
+	/**
+	 * the contents of the segment
+	 * @return a pointer to the first byte
+	 */
+	char* data() const;
+
+	/**
+	 * the size of the segment
+	 * @return the number of bytes
+	 */
+	std::size_t size() const;
+
+private:
+	SharedMemory(const SharedMemory&);
+	SharedMemory& operator=(const SharedMemory&);
+
+	char* bytes;			//the mapping
+	std::size_t length;		//the size of the segment
+};
+
+// 	-------------------------------------------------------------------------
+//	Class SharedBarrier is a barrier for processes, placed in shared memory
+//	and slept on with a futex. Unlike pthread_barrier_t it can be broken, and
+//	unlike a process shared condition variable it does not hang once one of
+//	its parties is killed while waiting
+// 	-------------------------------------------------------------------------
+class SharedBarrier {
+public:
+
+	/**
+	 * constructor
+	 * @param parties the number of processes that meet at the barrier
+	 */
+	explicit SharedBarrier(int parties);
+
+	/**
+	 * wait until every party has arrived
+	 * @param healthy if given, called every so often while waiting, returning
+	 *        false breaks the barrier
+	 * @return true if everyone arrived, false if the barrier is broken
+	 */
+	bool wait(const std::function<bool()>& healthy = std::function<bool()>());
+
+	/**
+	 * break the barrier, every wait, now or later, returns false
+	 */
+	void abort();
+
+private:
+	SharedBarrier(const SharedBarrier&);
+	SharedBarrier& operator=(const SharedBarrier&);
+
+	int parties;					//processes that meet at the barrier
+	std::atomic<int> waiting;		//processes waiting in this phase
+	std::atomic<int> phase;			//number of times everyone has arrived, the futex word
+	std::atomic<bool> broken;		//true once abort() was called
+};
+
+// 	-------------------------------------------------------------------------
+//	Class ProcessGroup forks worker processes that each run the same function
+//	with their own index, and keeps track of the ones that have exited
+// 	-------------------------------------------------------------------------
+class ProcessGroup {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if a worker cannot be forked. A
+	 * worker that returns from work exits with 0, one that throws with 1, and
+	 * every worker is killed when the process that made the group dies
+	 * @param n the number of workers
+	 * @param work the function every worker runs, with its index
+	 */
+	ProcessGroup(int n, const std::function<void(int)>& work);
+
+	/**
+	 * destructor, kills the workers still running and reaps them all
+	 */
+	~ProcessGroup();
+
+	/**
+	 * look for a worker that has exited, without waiting
+	 * @return the index of such a worker, -1 if they are all running
+	 */
+	int exited();
+
+	/**
+	 * wait for every worker to exit
+	 */
+	void join();
+
+	/**
+	 * kill every worker still running
+	 */
+	void kill_all();
+
+	/**
+	 * @param i the index of a worker
+	 * @return the process id of the worker
+	 */
+	pid_t pid(int i) const;
+
+private:
+	ProcessGroup(const ProcessGroup&);
+	ProcessGroup& operator=(const ProcessGroup&);
+
+	std::vector<pid_t> pids;	//the workers
+	std::vector<bool> running;	//false once a worker has been reaped
+};
+
+// 	-------------------------------------------------------------------------
+//	Generic Class CellSpan is a view of cells next to each other in memory,
+//	such as one row of a board
+// 	-------------------------------------------------------------------------
+template <class T>
+class CellSpan {
+public:
+
+	/**
+	 * constructor
+	 * @param f the first cell
+	 * @param n the number of cells
+	 */
+	CellSpan(T* f, int n) : cells(f), length(n) {}
+
+	/**
+	 * @return the first cell
+	 */
+	T* begin() const {
+		return cells;
+	}
+
+	/**
+	 * @return one past the last cell
+	 */
+	T* end() const {
+		return cells + length;
+	}
+
+	/**
+	 * @return the first cell
+	 */
+	T* data() const {
+		return cells;
+	}
+
+	/**
+	 * @return the number of cells
+	 */
+	int size() const {
+		return length;
+	}
+
+	/**
+	 * the cell at a position, only checked in debug builds
+	 * @param i the position
+	 * @return the cell
+	 */
+	T& operator[](int i) const {
+		assert(i >= 0 && i < length);
+		return cells[i];
+	}
+
+private:
+	T* cells;		//the first cell
+	int length;		//the number of cells
+};
+
+// 	----------------------------------------------------
+//	Generic Class Life has the board to the game of life
+//	----------------------------------------------------
+template <class T>
+class Life {
+public:
+
+	/**
+	 * constructor
+	 * @param in the istream to read from
+	 * @param h is the height of the board (without borders as they are hidden from the user)
+	 * @param w is the width of the board (without borders as they are hidden from the user)
+	 */	
+	Life(std::istream& in, int h, int w) {
+		init(h, w);
+
+		// a whole row at a time, up to the blank line that ends the board
+		std::string row;
+		int x = 0;
+		while (std::getline(in, row) && !row.empty())
+			load_row(x++, row.data(), static_cast<int>(row.size()));
+
+		if (x != height)
+			throw std::runtime_error("board has " + std::to_string(x) + " rows, not " + std::to_string(height));
+
+		next_board = board;	// borders of the back buffer never change
+	}
+
+	/**
+	 * constructor, the height and width are those of the board read
+	 * @param in the istream to read from, up to a blank line or the end
+	 */
+	explicit Life(std::istream& in) {
+		std::string text;
+		std::string row;
+		while (std::getline(in, row) && !row.empty()) {
+			text += row;
+			text += '\n';
+		}
+
+		load(text.data(), text.data() + text.size());
+	}
+
+	/**
+	 * constructor, parses a board straight out of memory, or restores it if
+	 * the memory holds a snapshot, the height and width are those of the
+	 * board found there
+	 * @param first the first character of the board
+	 * @param last one past the last character, or the board ends at a blank line
+	 */
+	Life(const char* first, const char* last) {
+		if (is_snapshot(first, last))
+			restore(first, last);
+		else
+			load(first, last);
+	}
+
+	/**
+	 * constructor, maps a board file into memory and parses it in place, or
+	 * restores it if the file is a snapshot, the height and width are those
+	 * of the board in the file
+	 * @param path the file to read
+	 */
+	explicit Life(const std::string& path) {
+		MappedFile file(path);
+		if (is_snapshot(file.data(), file.data() + file.size()))
+			restore(file.data(), file.data() + file.size());
+		else
+			load(file.data(), file.data() + file.size());
+	}
+
+	/**
+	 * the board, its generation and its population in the binary snapshot
+	 * format, see SnapshotHeader
+	 * @return the snapshot
+	 */
+	std::string snapshot() const {
+		const SnapshotHeader header = make_snapshot_header(CellTraits<T>::type(), height, width, generation, population);
+		const SnapshotLayout layout = snapshot_layout(header);
+
+		std::string bytes(layout.size, '\0');
+		char* p = &bytes[0];
+		std::memcpy(p, &header, sizeof(header));
+
+		std::uint64_t word = 0;
+		std::size_t i = 0;
+		for (int x = 0; x < height; x++) {
+			const T* cells = &board[(x + 1) * (width + 2) + 1];
+
+			for (int y = 0; y < width; y++, i++) {
+				if (cells[y].is_alive())
+					word |= std::uint64_t(1) << (i % 64);
+				if (i % 64 == 63) {
+					std::memcpy(p + layout.bits + (i / 64) * 8, &word, 8);
+					word = 0;
+				}
+				if (layout.ages != 0) {
+					const std::int32_t age = CellTraits<T>::age(cells[y]);
+					std::memcpy(p + layout.ages + i * 4, &age, 4);
+				}
+				if (layout.species != 0)
+					p[layout.species + i] = static_cast<char>(CellTraits<T>::species(cells[y]));
+			}
+		}
+		if (i % 64 != 0)
+			std::memcpy(p + layout.bits + (i / 64) * 8, &word, 8);
+
+		return bytes;
+	}
+
+	/**
+	 * write a snapshot of the board
+	 * @param out the ostream to write to
+	 */
+	void save(std::ostream& out) const {
+		const std::string bytes = snapshot();
+		out.write(bytes.data(), bytes.size());
+		out.flush();
+	}
+
+	/**
+	 * write a snapshot of the board to a file, the old file, if any, is only
+	 * replaced once the new one is complete
+	 * @param path the file to write
+	 */
+	void save(const std::string& path) const {
+		write_file(path, snapshot());
+	}
+
+	/**
+	 * write what changed since the last call, the whole board on the first
+	 * call. DeltaReader turns the stream back into frames
+	 * @param out the ostream to write to
+	 * @param format text or binary, the same on every call
+	 */
+	void print_delta(std::ostream& out, DeltaFormat format = DELTA_TEXT) {
+		delta.clear();
+
+		if (delta_state.empty()) {
+			const std::string& f = render();
+			const std::size_t n = static_cast<std::size_t>(height) * (width + 1) + 1;
+			append_delta_keyframe(delta, format, generation, population, height, width, f.data() + f.size() - n);
+
+			delta_state.resize(static_cast<std::size_t>(height) * width);
+			for (int x = 0; x < height; x++)
+				for (int y = 0; y < width; y++)
+					delta_state[x * width + y] = delta_code(board[(x + 1) * (width + 2) + y + 1]);
+		}
+		else {
+			delta_changes.clear();
+
+			for (int x = 0; x < height; x++) {
+				const T* cells = &board[(x + 1) * (width + 2) + 1];
+				std::int32_t* state = &delta_state[x * width];
+
+				for (int y = 0; y < width; y++) {
+					const std::int32_t code = delta_code(cells[y]);
+					if (code == state[y])
+						continue;
+
+					DeltaRecord r = {x, y, CellTraits<T>::age(cells[y]), 'A', cells[y].symbol(), {0, 0}};
+					if ((code ^ state[y]) & 1)
+						r.kind = (code & 1) ? 'B' : 'D';
+					delta_changes.push_back(r);
+					state[y] = code;
+				}
+			}
+
+			append_delta(delta, format, generation, population, delta_changes);
+		}
+
+		out.write(delta.data(), delta.size());
+		out.flush();
+	}
+
+	/**
+	 * print this cell's symbol, works for all cells
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out) {
+		const std::string& f = render();
+		out.write(f.data(), f.size());
+		out.flush();
+	}
+
+	/**
+	 * print the board straight to a file descriptor
+	 * @param fd the file descriptor to write to
+	 */
+	void print(int fd) {
+		write_all(fd, render());
+	}
+
+	/**
+	 * format the board the way print() does into a buffer that is reused
+	 * from frame to frame
+	 * @return the frame, valid until the next call
+	 */
+	const std::string& render() {
+		char* rows = begin_frame(frame, generation, population, height, width);
+
+		for (int x = 0; x < height; x++) {
+			const T* cells = &board[(x + 1) * (width + 2) + 1];
+			char* row = rows + x * (width + 1);
+
+			for (int y = 0; y < width; y++)
+				row[y] = cells[y].symbol();
+		}
+
+		return frame;
+	}
+
+	/**
+	 * will call the function evolve on the whole cell, the next generation
+	 * is written into the back buffer and then the buffers are swapped
+	 */
+	void evolve_all() {
+#ifdef LIFE_STATS
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		band_clones.assign(std::max<std::size_t>(band_population.size(), 1), 0);
+		band_allocations.assign(band_clones.size(), 0);
+#endif
+
+		if (tile_size > 0)
+			evolve_tiles();
+		else if (!pool)
+			run_band(0, [this] { population = evolve_rows(0, height); });
+		else {
+			const int bands = static_cast<int>(band_population.size());
+
+			pool->run(bands, [this, bands](int b) {
+				run_band(b, [this, bands, b] { band_population[b] = evolve_rows(height * b / bands, height * (b + 1) / bands); });
+			});
+
+			population = 0;
+			for (int b = 0; b < bands; b++)
+				population += band_population[b];
+		}
+
+#ifdef LIFE_STATS
+		last_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		last_stats.clones = 0;
+		last_stats.allocations = 0;
+		for (std::size_t b = 0; b < band_clones.size(); b++) {
+			last_stats.clones += band_clones[b];
+			last_stats.allocations += band_allocations[b];
+		}
+		count_stats();
+#endif
+
+		board.swap(next_board);
+		generation++;
+
+#ifdef LIFE_STATS
+		if (stats_callback)
+			stats_callback(last_stats);
+#endif
+	}
+
+#ifdef LIFE_STATS
+	/**
+	 * what the last evolve_all() did, all zero before the first one
+	 * @return the statistics
+	 */
+	const LifeStats& stats() const {
+		return last_stats;
+	}
+
+	/**
+	 * call f at the end of every evolve_all() with what it did
+	 * @param f the callback, an empty function removes it
+	 */
+	void set_stats_callback(std::function<void(const LifeStats&)> f) {
+		stats_callback = f;
+	}
+#endif
+
+	/**
+	 * split the board into square tiles and from now on only evolve the tiles
+	 * that changed in the last generation, or that touch one that did.
+	 * Cells edited through at() or an iterator are not tracked, call this
+	 * again after editing the board.
+	 * @param size the width and height of a tile, 0 evolves every cell again
+	 */
+	void set_tile_size(int size) {
+		assert(size >= 0);
+
+		tile_size = size;
+		if (size == 0)
+			return;
+
+		tile_rows = (height + size - 1) / size;
+		tile_columns = (width + size - 1) / size;
+
+		const int tiles = tile_rows * tile_columns;
+		tile_changed.assign(tiles, true);	// nothing is known about the last generation
+		next_tile_changed.assign(tiles, false);
+		tile_population.assign(tiles, 0);
+		active_tiles.clear();
+		active_tiles.reserve(tiles);
+
+		for (int t = 0; t < tiles; t++) {
+			const int x0 = (t / tile_columns) * size;
+			const int y0 = (t % tile_columns) * size;
+			for (int x = x0; x < std::min(x0 + size, height); x++)
+				for (int y = y0; y < std::min(y0 + size, width); y++)
+					if (at(x, y).is_alive())
+						tile_population[t]++;
+		}
+	}
+
+	/**
+	 * make jump_to() remember a hash of the board for each of the last
+	 * history generations, so it notices the board repeating itself and
+	 * skips whole cycles. Call this again after editing the board.
+	 * @param history how many generations to look back, 0 turns it off
+	 */
+	void set_cycle_detection(int history) {
+		assert(history >= 0);
+
+		cycle_history = history;
+		cycle_period = 0;
+		hashes.clear();
+		if (history > 0)
+			hashes.push_back(std::make_pair(board_hash(), generation));
+	}
+
+	/**
+	 * the period of the cycle jump_to() found the board in
+	 * @return the period, 0 if none was found
+	 */
+	int period() const {
+		return cycle_period;
+	}
+
+	/**
+	 * evolve up to a generation, same as calling evolve_all() until then.
+	 * With cycle detection on, once a hash repeats, the board is evolved one
+	 * more period and compared with a copy, and only if it came back exactly
+	 * are the remaining whole periods skipped. Throws std::invalid_argument
+	 * if the target is before the current generation.
+	 * @param target the generation to stop at
+	 */
+	void jump_to(int target) {
+		if (target < generation)
+			throw std::invalid_argument("Life::jump_to");
+
+		while (generation < target) {
+			if (cycle_period > 0) {
+				generation += (target - generation) / cycle_period * cycle_period;
+				while (generation < target)
+					evolve_all();
+				return;
+			}
+
+			evolve_all();
+			if (cycle_history == 0)
+				continue;
+
+			const int p = remember_board();
+			if (p > 0 && generation + p <= target) {
+				const std::vector<T> seen = board;
+				for (int i = 0; i < p; i++) {
+					evolve_all();
+					remember_board();
+				}
+
+				if (std::equal(board.begin(), board.end(), seen.begin()))
+					cycle_period = p;
+			}
+		}
+	}
+
+	/**
+	 * evolve count generations and write the board at every generation of
+	 * schedule, same bytes as calling print() at those generations, but a
+	 * writer thread does the writing while the board keeps evolving. Only
+	 * rendering the frame, one symbol per cell, is left to this thread.
+	 * Throws std::invalid_argument, before evolving anything, if count is
+	 * negative or the schedule is out of order or out of range.
+	 * @param count how many generations to evolve
+	 * @param schedule the generations to write, in increasing order, from
+	 *        the current one up to count generations later
+	 * @param out the ostream to write to
+	 * @param limit how many frames may wait for the writer before evolving waits
+	 */
+	void evolve_n(int count, const std::vector<int>& schedule, std::ostream& out, std::size_t limit = 4) {
+		if (count < 0)
+			throw std::invalid_argument("Life::evolve_n");
+		const int last = generation + count;
+
+		int previous = generation;
+		for (int g : schedule) {
+			if (g < previous || g > last)
+				throw std::invalid_argument("Life::evolve_n");
+			previous = g;
+		}
+
+		FrameWriter writer(out, limit);
+		for (int g : schedule) {
+			jump_to(g);
+			render();
+			writer.push(frame);
+		}
+
+		jump_to(last);
+		writer.finish();
+	}
+
+	/**
+	 * set how many threads evolve_all() uses, every thread gets a band of rows
+	 * @param threads the number of threads, 1 runs evolve_all() on the calling thread only
+	 */
+	void set_threads(int threads) {
+		assert(threads > 0);
+
+		if (threads == 1)
+			pool.reset();
+		else
+			pool.reset(new WorkerPool(threads));
+
+		band_population.assign(threads, 0);
+	}
+
+	/**
+	 * will retrieve the cell at position (x, y) in the board
+	 * @param x the horizontal variable (without borders as they are hidden from the user)
+	 * @param y the vertical variable (without borders as they are hidden from the user)
+	 * @return the cell at position (x,y)
+	 */	
+	T& at(int x, int y) {
+		return board.at((x + 1) * (width + 2) + y + 1);
+	}
+
+	/**
+	 * const version of at(), will retrieve the cell at position (x, y) in the board
+	 * @param x the horizontal variable (without borders as they are hidden from the user)
+	 * @param y the vertical variable (without borders as they are hidden from the user)
+	 * @return the cell at position (x,y)
+	 */	
+	const T& at(int x, int y) const {
+		return board.at((x + 1) * (width + 2) + y + 1);
+	}
+
+	// 	-------------------------------------------------------------------------
+	//	Nested Class cell_iterator walks the cells of the board row by row,
+	//	straight over the storage, skipping the border between two rows. It is a
+	//	random access iterator, so the standard algorithms, parallel ones
+	//	included, split the board between threads without walking it first. It
+	//	holds the board and an index rather than a pointer, so it stays valid,
+	//	and on the current generation, when evolve_all() swaps the buffers
+	// 	-------------------------------------------------------------------------
+	template <class C>
+	class cell_iterator {
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::remove_const<C>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef C* pointer;
+		typedef C& reference;
+
+		// the board, const for a const_iterator
+		typedef typename std::conditional<std::is_const<C>::value, const std::vector<value_type>, std::vector<value_type> >::type Board;
+
+		/**
+		 * constructor, an iterator that points nowhere
+		 */
+		cell_iterator() : board(nullptr), cell(0), row(0), y(0), width(0), height(0) {}
+
+		/**
+		 * constructor
+		 * @param b the board, bordered, rows are width + 2 cells apart
+		 * @param h the height of the board
+		 * @param w the width of the board
+		 * @param position x * w + y of the cell to point to, h * w for the end
+		 */
+		cell_iterator(Board* b, int h, int w, difference_type position) : board(b), width(w), height(h) {
+			seek(position);
+		}
+
+		/**
+		 * an iterator turns into a const_iterator to the same cell
+		 * @param rhs the iterator to copy
+		 */
+		template <class D, class = typename std::enable_if<std::is_convertible<D*, C*>::value>::type>
+		cell_iterator(const cell_iterator<D>& rhs) :
+			board(rhs.board), cell(rhs.cell), row(rhs.row), y(rhs.y), width(rhs.width), height(rhs.height) {}
+
+		/**
+		 * operator * will override the * operator for iterator, only checked in debug builds
+	 	 * @return a reference to the cell this iterator points to
+		 */
+		C& operator*() const {
+			assert(row >= 0 && row < height && y >= 0 && y < width);
+			return (*board)[cell];
+		}
+
+		/**
+	 	 * @return a pointer to the cell this iterator points to
+		 */
+		C* operator->() const {
+			return &**this;
+		}
+
+		/**
+	 	 * @param n how many cells further on
+	 	 * @return a reference to the cell n cells after this one
+		 */
+		C& operator[](difference_type n) const {
+			return *(*this + n);
+		}
+
+		/**
+		 * operator ++ will override the ++ operator for iterator and will iterate to the next element
+	 	 * @return a reference to the iterator pointing to the next element
+		 */
+		cell_iterator& operator++() {
+			++cell;
+			if (++y == width) {
+				cell += 2;
+				y = 0;
+				++row;
+			}
+			return *this;
+		}
+
+		/**
+	 	 * @return a copy of the iterator before it moved to the next element
+		 */
+		cell_iterator operator++(int) {
+			cell_iterator before = *this;
+			++*this;
+			return before;
+		}
+
+		/**
+		 * operator -- will override the -- operator for iterator and will iterate to the previous element
+	 	 * @return a reference to the iterator pointing to the previous element
+		 */
+		cell_iterator& operator--() {
+			if (y == 0) {
+				cell -= 2;
+				y = width;
+				--row;
+			}
+			--cell;
+			--y;
+			return *this;
+		}
+
+		/**
+	 	 * @return a copy of the iterator before it moved to the previous element
+		 */
+		cell_iterator operator--(int) {
+			cell_iterator before = *this;
+			--*this;
+			return before;
+		}
+
+		/**
+	 	 * @param n how many cells to move on, may be negative
+	 	 * @return this iterator
+		 */
+		cell_iterator& operator+=(difference_type n) {
+			seek(index() + n);
+			return *this;
+		}
+
+		/**
+	 	 * @param n how many cells to move back, may be negative
+	 	 * @return this iterator
+		 */
+		cell_iterator& operator-=(difference_type n) {
+			seek(index() - n);
+			return *this;
+		}
+
+		friend cell_iterator operator+(cell_iterator i, difference_type n) {
+			return i += n;
+		}
+
+		friend cell_iterator operator+(difference_type n, cell_iterator i) {
+			return i += n;
+		}
+
+		friend cell_iterator operator-(cell_iterator i, difference_type n) {
+			return i -= n;
+		}
+
+		friend difference_type operator-(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return lhs.index() - rhs.index();
+		}
+
+		/**
+		 * operator == will override the == operator for iterator
+	 	 * @return a bool with the value of the comparison
+		 */
+		friend bool operator==(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return lhs.cell == rhs.cell;
+		}
+
+		/**
 		 * operator != will override the != operator for iterator
 	 	 * @return a bool with the value of the comparison
-		 */	
-		bool operator!=(const iterator<T2>& rhs) const {
-			return !(*this == rhs);
+		 */
+		friend bool operator!=(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return lhs.cell != rhs.cell;
+		}
+
+		friend bool operator<(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return lhs.index() < rhs.index();
+		}
+
+		friend bool operator>(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const cell_iterator& lhs, const cell_iterator& rhs) {
+			return !(lhs < rhs);
+		}
+
+	private:
+		template <class D>
+		friend class cell_iterator;
+
+		/**
+		 * @return x * width + y of the cell pointed to
+		 */
+		difference_type index() const {
+			return row * width + y;
+		}
+
+		/**
+		 * point to another cell
+		 * @param position x * width + y of the cell
+		 */
+		void seek(difference_type position) {
+			row = (width > 0) ? position / width : 0;
+			y = (width > 0) ? static_cast<int>(position % width) : 0;
+			cell = (row + 1) * (width + 2) + y + 1;
+		}
+
+		Board* board;			//the board, not its storage, which evolving swaps
+		difference_type cell;	//index in board of the cell pointed to
+		difference_type row;	//current x
+		int y;					//current y
+		int width;				//width of the board
+		int height;				//height of the board, for the debug checks
+	};
+
+	template <class T2>
+	using iterator = cell_iterator<T2>;
+
+	template <class T2>
+	using const_iterator = cell_iterator<const T2>;
+
+	/*
+	 * return the first element in board
+	 * @return the first element in board
+	 */
+	iterator<T> begin() {
+		return iterator<T>(&board, height, width, 0);
+	}
+
+	/*
+	 * return the first element in board
+	 * @return the first element in board
+	 */
+	const_iterator<T> begin() const {
+		return const_iterator<T>(&board, height, width, 0);
+	}
+
+	/*
+	 * return one past the last element in board
+	 * @return one past the last element in board
+	 */
+	iterator<T> end() {
+		return iterator<T>(&board, height, width, static_cast<std::ptrdiff_t>(height) * width);
+	}
+
+	/*
+	 * return one past the last element in board
+	 * @return one past the last element in board
+	 */
+	const_iterator<T> end() const {
+		return const_iterator<T>(&board, height, width, static_cast<std::ptrdiff_t>(height) * width);
+	}
+
+	/**
+	 * the cells of one row, without the bounds check of at() in release builds,
+	 * like data() only good until the board next evolves
+	 * @param x the row
+	 * @return a view of width cells
+	 */
+	CellSpan<T> row(int x) {
+		assert(x >= 0 && x < height);
+		return CellSpan<T>(data() + static_cast<std::ptrdiff_t>(x) * stride(), width);
+	}
+
+	/**
+	 * const version of row()
+	 * @param x the row
+	 * @return a view of width cells
+	 */
+	CellSpan<const T> row(int x) const {
+		assert(x >= 0 && x < height);
+		return CellSpan<const T>(data() + static_cast<std::ptrdiff_t>(x) * stride(), width);
+	}
+
+	/**
+	 * the storage of the board, cell (x, y) is data()[x * stride() + y]. The
+	 * cells between two rows are borders and must be left alone. Evolving
+	 * swaps the storage for the back buffer, so the pointer is only good until
+	 * the board next evolves
+	 * @return the cell at (0, 0)
+	 */
+	T* data() {
+		return &board[width + 3];
+	}
+
+	/**
+	 * const version of data()
+	 * @return the cell at (0, 0)
+	 */
+	const T* data() const {
+		return &board[width + 3];
+	}
+
+	/**
+	 * @return the distance between two rows in data()
+	 */
+	std::ptrdiff_t stride() const {
+		return width + 2;
+	}
+private:
+	int height;			//max height
+	int width;			//max width
+	std::vector<T> board;	//the board itself
+	std::vector<T> next_board;	//back buffer the next generation is written to
+	std::ptrdiff_t offsets[8];	//offset from a cell in board to each of its neighbors
+
+	int generation;			//generation tracker
+	int population;			//population tracker
+
+	/**
+	 * set up an empty board, filled with borders
+	 * @param h is the height of the board
+	 * @param w is the width of the board
+	 */
+	void init(int h, int w) {
+		width = w;
+		height = h;
+		generation = 0;
+		population = 0;
+		tile_size = 0;
+		tile_rows = 0;
+		tile_columns = 0;
+		cycle_history = 0;
+		cycle_period = 0;
+		hashes.clear();
+
+#ifdef LIFE_STATS
+		last_stats = LifeStats();
+#endif
+
+		board.assign((width + 2) * (height + 2), T(true)); // initialize board, fill it with borders
+
+		const std::ptrdiff_t s = width + 2;
+		const std::ptrdiff_t o[8] = {-1, s, 1, -s, s - 1, s + 1, -s + 1, -s - 1};
+		std::copy(o, o + 8, offsets);
+	}
+
+	/**
+	 * parse one row of symbols straight into the board, throws
+	 * std::runtime_error if the row is not on the board or not width long
+	 * @param x the row
+	 * @param row the symbols
+	 * @param n the number of symbols
+	 */
+	void load_row(int x, const char* row, int n) {
+		if (x >= height)
+			throw std::runtime_error("board has more than " + std::to_string(height) + " rows");
+		if (n != width)
+			throw std::runtime_error("row " + std::to_string(x) + " is " + std::to_string(n) + " cells wide, not " + std::to_string(width));
+
+		T* cells = &board[(x + 1) * (width + 2) + 1];
+		for (int y = 0; y < n; y++) {
+			cells[y] = T(row[y]);
+
+			if (cells[y].is_alive())
+				population++;
+		}
+	}
+
+	/**
+	 * size the board after the text and parse it
+	 * @param first the first character of the board
+	 * @param last one past the last character, or the board ends at a blank line
+	 */
+	void load(const char* first, const char* last) {
+		const char* end = (first < last) ? static_cast<const char*>(std::memchr(first, '\n', last - first)) : nullptr;
+		const int w = static_cast<int>((end == nullptr ? last : end) - first);
+
+		// count the rows up to the blank line
+		int h = 0;
+		for (const char* p = first; p < last && *p != '\n'; h++) {
+			const char* eol = static_cast<const char*>(std::memchr(p, '\n', last - p));
+			p = (eol == nullptr) ? last : eol + 1;
+		}
+
+		init(h, w);
+
+		const char* p = first;
+		for (int x = 0; x < h; x++) {
+			const char* eol = static_cast<const char*>(std::memchr(p, '\n', last - p));
+			const char* row_end = (eol == nullptr) ? last : eol;
+			load_row(x, p, static_cast<int>(row_end - p));
+			p = row_end + 1;
+		}
+
+		next_board = board;	// borders of the back buffer never change
+	}
+
+	/**
+	 * size the board after a snapshot and decode the cells straight out of
+	 * it, throws std::runtime_error if it is not a snapshot of this kind of
+	 * board
+	 * @param first the first byte of the snapshot
+	 * @param last one past the last byte
+	 */
+	void restore(const char* first, const char* last) {
+		const SnapshotHeader header = read_snapshot_header(first, last, CellTraits<T>::type());
+		const SnapshotLayout layout = snapshot_layout(header);
+
+		init(header.height, header.width);
+		generation = static_cast<int>(header.generation);
+		population = static_cast<int>(header.population);
+
+		std::uint64_t word = 0;
+		std::size_t i = 0;
+		for (int x = 0; x < height; x++) {
+			T* cells = &board[(x + 1) * (width + 2) + 1];
+
+			for (int y = 0; y < width; y++, i++) {
+				if (i % 64 == 0)
+					std::memcpy(&word, first + layout.bits + (i / 64) * 8, 8);
+
+				std::int32_t age = 0;
+				if (layout.ages != 0)
+					std::memcpy(&age, first + layout.ages + i * 4, 4);
+				const std::uint8_t species = (layout.species != 0) ? static_cast<std::uint8_t>(first[layout.species + i]) : CellTraits<T>::species(cells[y]);
+
+				cells[y] = CellTraits<T>::make(species, (word >> (i % 64)) & 1, age);
+			}
+		}
+
+		next_board = board;	// borders of the back buffer never change
+	}
+
+	/**
+	 * evolve a band of rows into the back buffer
+	 * @param first the first row of the band
+	 * @param last one past the last row of the band
+	 * @return the population of the band in the next generation
+	 */
+	int evolve_rows(int first, int last) {
+		int band = 0;
+
+		for (int x = first; x < last; x++) {
+			for (int y = 0; y < width; y++) {
+				const int i = (x + 1) * (width + 2) + y + 1;
+
+				T& new_cell = next_board[i];
+				new_cell = board[i] + Neighborhood<T>(&board[i], offsets);
+
+				if (new_cell.is_alive())
+					band++;
+			}
+		}
+
+		return band;
+	}
+
+	/**
+	 * run the share of a generation one thread works on, counting the cells
+	 * it clones on that thread when built with -DLIFE_STATS
+	 * @param b the band
+	 * @param work the share
+	 */
+	template <class F>
+	void run_band(int b, F work) {
+#ifdef LIFE_STATS
+		const unsigned long long clones = cell_clones();
+		const unsigned long long allocations = cell_allocations();
+		work();
+		band_clones[b] = cell_clones() - clones;
+		band_allocations[b] = cell_allocations() - allocations;
+#else
+		(void) b;
+		work();
+#endif
+	}
+
+	/**
+	 * evolve the tiles that may change, every other tile keeps its cached
+	 * population and, having been stable for a generation, already holds the
+	 * same cells in both buffers
+	 */
+	void evolve_tiles() {
+		active_tiles.clear();
+
+		for (int tx = 0; tx < tile_rows; tx++) {
+			for (int ty = 0; ty < tile_columns; ty++) {
+				bool active = false;
+				for (int i = std::max(tx - 1, 0); i < std::min(tx + 2, tile_rows) && !active; i++)
+					for (int j = std::max(ty - 1, 0); j < std::min(ty + 2, tile_columns) && !active; j++)
+						active = tile_changed[i * tile_columns + j];
+
+				const int t = tx * tile_columns + ty;
+				next_tile_changed[t] = false;
+				if (active)
+					active_tiles.push_back(t);
+			}
+		}
+
+		if (!pool) {
+			run_band(0, [this] {
+				for (int k = 0; k < static_cast<int>(active_tiles.size()); k++)
+					evolve_tile(active_tiles[k]);
+			});
+		} else {
+			const int bands = static_cast<int>(band_population.size());
+			const int n = static_cast<int>(active_tiles.size());
+
+			pool->run(bands, [this, bands, n](int b) {
+				run_band(b, [this, bands, n, b] {
+					for (int k = n * b / bands; k < n * (b + 1) / bands; k++)
+						evolve_tile(active_tiles[k]);
+				});
+			});
+		}
+
+		population = 0;
+		for (int t = 0; t < tile_rows * tile_columns; t++)
+			population += tile_population[t];
+
+		tile_changed.swap(next_tile_changed);
+	}
+
+	/**
+	 * evolve one tile into the back buffer and record whether it changed
+	 * @param t the index of the tile
+	 */
+	void evolve_tile(int t) {
+		const int x0 = (t / tile_columns) * tile_size;
+		const int y0 = (t % tile_columns) * tile_size;
+		const int x1 = std::min(x0 + tile_size, height);
+		const int y1 = std::min(y0 + tile_size, width);
+
+		int count = 0;
+		bool changed = false;
+
+		for (int x = x0; x < x1; x++) {
+			for (int y = y0; y < y1; y++) {
+				const int i = (x + 1) * (width + 2) + y + 1;
+
+				T& new_cell = next_board[i];
+				new_cell = board[i] + Neighborhood<T>(&board[i], offsets);
+
+				if (new_cell.is_alive())
+					count++;
+				if (!changed && new_cell != board[i])
+					changed = true;
+			}
+		}
+
+		tile_population[t] = count;
+		next_tile_changed[t] = changed;
+	}
+
+#ifdef LIFE_STATS
+	/**
+	 * compare the back buffer with the board to fill in everything but the
+	 * timing and cloning of last_stats, a pass over the whole board
+	 */
+	void count_stats() {
+		LifeStats& s = last_stats;
+		s.generation = generation + 1;
+		s.evaluated = 0;
+		s.changed = 0;
+		s.births = 0;
+		s.deaths = 0;
+		std::fill(s.ages, s.ages + 11, 0);
+
+		if (tile_size == 0)
+			s.evaluated = static_cast<long long>(height) * width;
+		else
+			for (int k = 0; k < static_cast<int>(active_tiles.size()); k++) {
+				const int t = active_tiles[k];
+				const int x0 = (t / tile_columns) * tile_size;
+				const int y0 = (t % tile_columns) * tile_size;
+				s.evaluated += static_cast<long long>(std::min(tile_size, height - x0)) * std::min(tile_size, width - y0);
+			}
+
+		for (int x = 0; x < height; x++) {
+			const T* old_cells = &board[(x + 1) * (width + 2) + 1];
+			const T* new_cells = &next_board[(x + 1) * (width + 2) + 1];
+
+			for (int y = 0; y < width; y++) {
+				const bool was_alive = old_cells[y].is_alive();
+				const bool is_alive = new_cells[y].is_alive();
+
+				if (new_cells[y] != old_cells[y])
+					s.changed++;
+				if (!was_alive && is_alive)
+					s.births++;
+				if (was_alive && !is_alive)
+					s.deaths++;
+				if (is_alive && CellTraits<T>::species(new_cells[y]) == FREDKIN)
+					s.ages[std::min(CellTraits<T>::age(new_cells[y]), 10)]++;
+			}
+		}
+	}
+
+	LifeStats last_stats;									//what the last evolve_all() did
+	std::function<void(const LifeStats&)> stats_callback;	//called after every evolve_all(), may be empty
+#endif
+
+	/**
+	 * a hash of the symbols on the board
+	 * @return the hash
+	 */
+	std::uint64_t board_hash() const {
+		std::uint64_t h = 14695981039346656037ULL;
+
+		for (int x = 0; x < height; x++) {
+			const T* cells = &board[(x + 1) * (width + 2) + 1];
+
+			for (int y = 0; y < width; y++)
+				h = (h ^ static_cast<unsigned char>(cells[y].symbol())) * 1099511628211ULL;
+		}
+
+		return h;
+	}
+
+	/**
+	 * add the hash of the board to the history, forgetting the oldest
+	 * @return how many generations ago the same hash was seen, 0 if it was not
+	 */
+	int remember_board() {
+		const std::uint64_t h = board_hash();
+
+		int p = 0;
+		for (std::deque<std::pair<std::uint64_t, int> >::reverse_iterator i = hashes.rbegin(); i != hashes.rend() && p == 0; ++i)
+			if (i->first == h)
+				p = generation - i->second;
+
+		hashes.push_back(std::make_pair(h, generation));
+		if (static_cast<int>(hashes.size()) > cycle_history)
+			hashes.pop_front();
+
+		return p;
+	}
+
+	int cycle_history;		//generations of hashes kept, 0 when cycle detection is off
+	int cycle_period;		//period of the cycle found, 0 if none
+	std::deque<std::pair<std::uint64_t, int> > hashes;	//hash and generation of recent boards, newest last
+
+	/**
+	 * a cell as print_delta() remembers it
+	 * @param c the cell
+	 * @return alive in bit 0, species in bit 1, age above
+	 */
+	static std::int32_t delta_code(const T& c) {
+		return (CellTraits<T>::age(c) << 2) | (CellTraits<T>::species(c) << 1) | (c.is_alive() ? 1 : 0);
+	}
+
+	std::string frame;		//the last frame rendered
+
+	std::vector<std::int32_t> delta_state;		//delta_code() of every cell as print_delta() last wrote it
+	std::vector<DeltaRecord> delta_changes;		//cells changed since the last delta
+	std::string delta;							//the last delta written
+
+	std::unique_ptr<WorkerPool> pool;	//workers for evolve_all(), null when single threaded
+	std::vector<int> band_population;	//population of every band in the last generation
+#ifdef LIFE_STATS
+	std::vector<unsigned long long> band_clones;		//cells every band cloned in the last generation
+	std::vector<unsigned long long> band_allocations;	//cells every band cloned on the heap in the last generation
+#endif
+
+	int tile_size;			//width and height of a tile, 0 when every cell is evolved
+	int tile_rows;			//tiles down the board
+	int tile_columns;		//tiles across the board
+	std::vector<char> tile_changed;			//did the tile change in the last generation?
+	std::vector<char> next_tile_changed;	//did the tile change in this generation?
+	std::vector<int> tile_population;		//cached population of every tile
+	std::vector<int> active_tiles;			//tiles evolved in this generation
+
+	FRIEND_TEST(LifeFixture, life_construct1);
+	FRIEND_TEST(LifeFixture, life_construct2);
+	FRIEND_TEST(LifeFixture, life_construct3);
+	FRIEND_TEST(LifeFixture, life_evolve_all6);
+	FRIEND_TEST(LifeFixture, life_neighborhood1);
+	FRIEND_TEST(LifeFixture, life_evolve_all_tiles4);
+};
+
+// 	-------------------------------------------------------------------------
+//	Generic Class SparseLife plays on an unbounded plane stored as square
+//	chunks allocated where something lives and freed once they are empty again.
+//	Chunks are keyed on both 64-bit chunk coordinates, so the plane spans every
+//	long long coordinate without wrapping around
+// 	-------------------------------------------------------------------------
+template <class T>
+class SparseLife {
+public:
+
+	/**
+	 * constructor
+	 * @param in the istream to read from, same format as Life<T>
+	 * @param h is the height of the board read in, placed at (0, 0)
+	 * @param w is the width of the board read in, placed at (0, 0)
+	 */
+	SparseLife(std::istream& in, int h, int w) : background(CellTraits<T>::dead()), spare(background) {
+		width = w;
+		height = h;
+		generation = 0;
+		population = 0;
+
+		int x = 0;
+		int y = 0;
+
+		while (true) {
+			int input = in.get();
+
+			if (input == EOF || (input == '\n' && y == 0))
+				break;
+
+			if (input == '\n') {
+				x++;
+				assert(y == width);
+				y = 0;
+				continue;
+			}
+
+			const T new_cell((char) input);
+
+			if (new_cell != background) {
+				Chunk& c = chunk(Key(floor_div(x), floor_div(y)));
+				c.cells[(x - floor_div(x) * chunk_size) * chunk_size + y - floor_div(y) * chunk_size] = new_cell;
+				if (new_cell.is_alive()) {
+					c.population++;
+					population++;
+				}
+			}
+
+			y++;
+		}
+
+		assert(x == height);
+
+		scratch.resize((chunk_size + 2) * (chunk_size + 2), background);
+
+		const std::ptrdiff_t s = chunk_size + 2;
+		const std::ptrdiff_t o[8] = {-1, s, 1, -s, s - 1, s + 1, -s + 1, -s - 1};
+		std::copy(o, o + 8, offsets);
+	}
+
+	/**
+	 * print the board read in, same format as Life<T>::print(), the population
+	 * counts the whole plane
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out) {
+		print(out, 0, 0, height, width);
+	}
+
+	/**
+	 * print any window of the plane
+	 * @param out the ostream to write to
+	 * @param x the row of the top left corner
+	 * @param y the column of the top left corner
+	 * @param h the height of the window
+	 * @param w the width of the window
+	 */
+	void print(std::ostream& out, long long x, long long y, int h, int w) {
+		char* rows = begin_frame(frame, generation, population, h, w);
+
+		for (int i = 0; i < h; i++)
+			for (int j = 0; j < w; j++)
+				rows[i * (w + 1) + j] = at(x + i, y + j).symbol();
+
+		out.write(frame.data(), frame.size());
+		out.flush();
+	}
+
+	/**
+	 * evolve every chunk that has something alive in or next to it, in place:
+	 * chunks are only allocated when life spreads into them and freed once
+	 * they hold nothing but empty space
+	 */
+	void evolve_all() {
+		// a chunk with nothing alive in or around it cannot change
+		alive.clear();
+		for (typename Map::const_iterator i = chunks.begin(); i != chunks.end(); i++)
+			if (i->second.population > 0)
+				alive.push_back(i->first);
+
+		active.clear();
+		fresh.clear();
+		for (const Key& k : alive)
+			for (long long dx = -1; dx <= 1; dx++)
+				for (long long dy = -1; dy <= 1; dy++) {
+					const Key n(k.first + dx, k.second + dy);
+					typename Map::iterator i = chunks.find(n);
+					if (i == chunks.end())
+						fresh.push_back(n);
+					else if (!i->second.active) {
+						i->second.active = true;
+						active.push_back(std::make_pair(n, &i->second));
+					}
+				}
+
+		for (const std::pair<Key, Chunk*>& a : active)
+			evolve_chunk(a.first, *a.second);
+
+		// a chunk life may spread into is only allocated if it does. It starts
+		// out as empty space, so the chunks evolved after it read the same
+		// cells as before, and references into the map survive the insert
+		std::sort(fresh.begin(), fresh.end());
+		fresh.erase(std::unique(fresh.begin(), fresh.end()), fresh.end());
+		for (const Key& k : fresh) {
+			evolve_chunk(k, spare);
+			if (spare.next_population > 0 || !is_empty(spare.next)) {
+				Chunk& c = chunk(k);
+				c.next.swap(spare.next);
+				c.next_population = spare.next_population;
+				c.active = true;
+				active.push_back(std::make_pair(k, &c));
+			}
+		}
+
+		for (const std::pair<Key, Chunk*>& a : active) {
+			Chunk& c = *a.second;
+			population += c.next_population - c.population;
+			c.cells.swap(c.next);
+			c.population = c.next_population;
+			c.active = false;
+			if (c.population == 0 && is_empty(c.cells))
+				chunks.erase(a.first);
+		}
+
+		generation++;
+	}
+
+	/**
+	 * will retrieve the cell at position (x, y) of the plane
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return the cell at position (x,y), empty space if no chunk holds it
+	 */
+	const T& at(long long x, long long y) const {
+		typename Map::const_iterator i = chunks.find(Key(floor_div(x), floor_div(y)));
+		if (i == chunks.end())
+			return background;
+		return i->second.cells[(x - floor_div(x) * chunk_size) * chunk_size + y - floor_div(y) * chunk_size];
+	}
+
+	/**
+	 * how many chunks are allocated?
+	 * @return the number of chunks
+	 */
+	std::size_t chunk_count() const {
+		return chunks.size();
+	}
+
+private:
+	static const int chunk_size = 16;	//width and height of a chunk
+
+	struct Chunk {
+		std::vector<T> cells;	//row major cells of the chunk
+		std::vector<T> next;	//back buffer the next generation is written to
+		int population;			//live cells in the chunk
+		int next_population;	//live cells in the back buffer
+		bool active;			//is it evolving this generation?
+
+		Chunk(const T& background) :
+			cells(chunk_size * chunk_size, background), next(cells), population(0), next_population(0), active(false) {}
+	};
+
+	typedef std::pair<long long, long long> Key;	//row and column of a chunk
+
+	struct KeyHash {
+		std::size_t operator()(const Key& k) const {
+			std::uint64_t h = k.first;
+			h = h * 0x9E3779B97F4A7C15ULL + k.second;
+			return static_cast<std::size_t>(h ^ (h >> 29));
+		}
+	};
+
+	typedef std::unordered_map<Key, Chunk, KeyHash> Map;
+
+	static long long floor_div(long long v) {
+		return v >= 0 ? v / chunk_size : -((-v - 1) / chunk_size) - 1;
+	}
+
+	/**
+	 * find or allocate a chunk
+	 */
+	Chunk& chunk(const Key& k) {
+		typename Map::iterator i = chunks.find(k);
+		if (i == chunks.end())
+			i = chunks.insert(std::make_pair(k, Chunk(background))).first;
+		return i->second;
+	}
+
+	/**
+	 * is every cell of a chunk empty space?
+	 * @param cells the cells of the chunk or of its back buffer
+	 */
+	bool is_empty(const std::vector<T>& cells) const {
+		for (int i = 0; i < chunk_size * chunk_size; i++)
+			if (cells[i] != background)
+				return false;
+		return true;
+	}
+
+	/**
+	 * evolve a chunk into its back buffer
+	 * @param k the key of the chunk
+	 * @param chunk the chunk
+	 */
+	void evolve_chunk(const Key& k, Chunk& chunk) {
+		const int s = chunk_size + 2;
+
+		// copy the chunk and a ring of its neighbors into scratch
+		const Chunk* around[3][3];
+		for (int dx = 0; dx < 3; dx++)
+			for (int dy = 0; dy < 3; dy++) {
+				typename Map::const_iterator i = chunks.find(Key(k.first + dx - 1, k.second + dy - 1));
+				around[dx][dy] = (i == chunks.end()) ? nullptr : &i->second;
+			}
+
+		for (int i = 0; i < s; i++) {
+			const int dx = (i == 0) ? 0 : (i == s - 1) ? 2 : 1;
+			const int ci = (i + chunk_size - 1) % chunk_size;
+			for (int j = 0; j < s; j++) {
+				const int dy = (j == 0) ? 0 : (j == s - 1) ? 2 : 1;
+				const int cj = (j + chunk_size - 1) % chunk_size;
+				const Chunk* c = around[dx][dy];
+				scratch[i * s + j] = (c == nullptr) ? background : c->cells[ci * chunk_size + cj];
+			}
+		}
+
+		chunk.next_population = 0;
+		for (int i = 0; i < chunk_size; i++) {
+			for (int j = 0; j < chunk_size; j++) {
+				const int n = (i + 1) * s + j + 1;
+
+				T& new_cell = chunk.next[i * chunk_size + j];
+				new_cell = scratch[n] + Neighborhood<T>(&scratch[n], offsets);
+
+				if (new_cell.is_alive())
+					chunk.next_population++;
+			}
+		}
+	}
+
+	int height;			//height of the board read in
+	int width;			//width of the board read in
+	const T background;	//the cell that fills empty space
+
+	Map chunks;			//every chunk that holds something
+	Chunk spare;		//where chunks not allocated yet are evolved
+	std::vector<Key> alive;		//chunks with something alive, while evolving
+	std::vector<Key> fresh;		//chunks next to them not allocated yet, while evolving
+	std::vector<std::pair<Key, Chunk*> > active;	//chunks that can change, while evolving
+	std::string frame;	//the last frame printed
+	std::vector<T> scratch;		//a chunk and the ring around it, while evolving
+	std::ptrdiff_t offsets[8];	//offset from a cell in scratch to each of its neighbors
+
+	int generation;			//generation tracker
+	int population;			//population tracker
+};
+
+// 	-------------------------------------------------------------------------
+//	Generic Class TiledLife plays the same game as Life<T> but stores the board
+//	as square tiles, each contiguous and ringed by a halo of its neighbors'
+//	edge cells, so evolving a cell only touches memory of its own tile however
+//	wide the board is. at(), the iterators and print() show the usual rows.
+// 	-------------------------------------------------------------------------
+template <class T>
+class TiledLife {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if a row is not w wide or the
+	 * board does not have h rows
+	 * @param in the istream to read from, same format as Life<T>
+	 * @param h is the height of the board
+	 * @param w is the width of the board
+	 * @param tile the width and height of a tile, pick it so a tile of T fits in cache
+	 */
+	TiledLife(std::istream& in, int h, int w, int tile = 64) {
+		assert(h >= 0 && w >= 0 && tile > 0);
+
+		height = h;
+		width = w;
+		tile_size = tile;
+		tile_rows = (h + tile - 1) / tile;
+		tile_columns = (w + tile - 1) / tile;
+		stride = tile + 2;
+		generation = 0;
+		population = 0;
+
+		// cells and halo cells past the edge of the board stay borders for good
+		tiles.assign(static_cast<std::size_t>(tile_rows) * tile_columns * stride * stride, T(true));
+
+		const std::ptrdiff_t s = stride;
+		const std::ptrdiff_t o[8] = {-1, s, 1, -s, s - 1, s + 1, -s + 1, -s - 1};
+		std::copy(o, o + 8, offsets);
+
+		std::string row;
+		int x = 0;
+		while (std::getline(in, row) && !row.empty()) {
+			if (x >= height)
+				throw std::runtime_error("board has more than " + std::to_string(height) + " rows");
+			if (static_cast<int>(row.size()) != width)
+				throw std::runtime_error("row " + std::to_string(x) + " is " + std::to_string(row.size()) + " cells wide, not " + std::to_string(width));
+
+			for (int y = 0; y < width; y++) {
+				T& c = tiles[index(x, y)];
+				c = T(row[y]);
+				if (c.is_alive())
+					population++;
+			}
+			x++;
+		}
+
+		if (x != height)
+			throw std::runtime_error("board has " + std::to_string(x) + " rows, not " + std::to_string(height));
+
+		next_tiles = tiles;
+	}
+
+	/**
+	 * print the board, same format as Life<T>::print()
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out) {
+		char* rows = begin_frame(frame, generation, population, height, width);
+
+		for (int x = 0; x < height; x++)
+			for (int y = 0; y < width; y++)
+				rows[x * (width + 1) + y] = tiles[index(x, y)].symbol();
+
+		out.write(frame.data(), frame.size());
+		out.flush();
+	}
+
+	/**
+	 * evolve the whole board one generation: fill in every halo from the
+	 * tiles around it, then evolve the tiles one after another
+	 */
+	void evolve_all() {
+		for (int t = 0; t < tile_rows * tile_columns; t++)
+			fill_halo(t);
+
+		population = 0;
+		for (int t = 0; t < tile_rows * tile_columns; t++)
+			population += evolve_tile(t);
+
+		tiles.swap(next_tiles);
+		generation++;
+	}
+
+	/**
+	 * will retrieve the cell at position (x, y) in the board, throws
+	 * std::out_of_range outside of it
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return the cell at position (x,y)
+	 */
+	T& at(int x, int y) {
+		check(x, y);
+		return tiles[index(x, y)];
+	}
+
+	/**
+	 * const version of at()
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return the cell at position (x,y)
+	 */
+	const T& at(int x, int y) const {
+		check(x, y);
+		return tiles[index(x, y)];
+	}
+
+	// 	-------------------------------------------------------------------------
+	//	Nested Class basic_iterator walks the board row by row straight over
+	//	the tiles, a step along a row is one cell on, or on to the next tile
+	//	at the edge of a tile. It holds the board and an index into its
+	//	storage, so it stays on the current generation when evolve_all() swaps
+	//	the buffers
+	// 	-------------------------------------------------------------------------
+	template <class L, class C>
+	class basic_iterator {
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef typename std::remove_const<C>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef C* pointer;
+		typedef C& reference;
+
+		/**
+		 * constructor, an iterator that points nowhere
+		 */
+		basic_iterator() : life(nullptr), cell(0), x(0), y(0), column(0), width(0), tile_size(0), jump(0) {}
+
+		/**
+		 * constructor
+		 * @param l the board to iterate over
+		 * @param i the position, x * width + y, height * width for the end
+		 */
+		basic_iterator(L& l, long long i) :
+				life(&l), width(l.width), tile_size(l.tile_size), jump(static_cast<std::size_t>(l.stride) * l.stride - l.tile_size + 1) {
+			seek(i);
+		}
+
+		/**
+		 * an iterator turns into a const_iterator to the same cell
+		 * @param rhs the iterator to copy
+		 */
+		template <class M, class D, class = typename std::enable_if<std::is_convertible<D*, C*>::value>::type>
+		basic_iterator(const basic_iterator<M, D>& rhs) :
+			life(rhs.life), cell(rhs.cell), x(rhs.x), y(rhs.y), column(rhs.column), width(rhs.width), tile_size(rhs.tile_size), jump(rhs.jump) {}
+
+		/**
+		 * only checked in debug builds
+		 * @return the cell this iterator points to
+		 */
+		C& operator*() const {
+			assert(x >= 0 && x < life->height && y >= 0 && y < life->width);
+			return life->tiles[cell];
+		}
+
+		/**
+		 * @return a pointer to the cell this iterator points to
+		 */
+		C* operator->() const {
+			return &**this;
+		}
+
+		/**
+		 * @return this iterator, moved to the next cell
+		 */
+		basic_iterator& operator++() {
+			if (++y == width)
+				seek((x + 1) * static_cast<long long>(width));
+			else if (++column == tile_size) {
+				cell += jump;
+				column = 0;
+			}
+			else
+				++cell;
+			return *this;
+		}
+
+		/**
+		 * @return a copy of the iterator before it moved to the next cell
+		 */
+		basic_iterator operator++(int) {
+			basic_iterator before = *this;
+			++*this;
+			return before;
+		}
+
+		/**
+		 * @return this iterator, moved to the previous cell
+		 */
+		basic_iterator& operator--() {
+			if (column == 0)
+				seek(x * static_cast<long long>(width) + y - 1);
+			else {
+				--cell;
+				--column;
+				--y;
+			}
+			return *this;
+		}
+
+		/**
+		 * @return a copy of the iterator before it moved to the previous cell
+		 */
+		basic_iterator operator--(int) {
+			basic_iterator before = *this;
+			--*this;
+			return before;
+		}
+
+		/**
+		 * @return true if both point to the same cell
+		 */
+		friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) {
+			return lhs.cell == rhs.cell;
+		}
+
+		/**
+		 * @return the negation of ==
+		 */
+		friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) {
+			return !(lhs == rhs);
 		}
+
 	private:
-		Life<T2>& life;		//the board that will be iterated over
-		int x;				//current x
-		int y;				//current y
+		template <class M, class D>
+		friend class basic_iterator;
+
+		/**
+		 * point to another cell, or to the end past the last row
+		 * @param position x * width + y of the cell
+		 */
+		void seek(long long position) {
+			x = (width > 0) ? static_cast<int>(position / width) : life->height;
+			y = (width > 0) ? static_cast<int>(position % width) : 0;
+			column = y % tile_size;
+			cell = (x < life->height) ? life->index(x, y) : 0;	// a halo cell, never walked over
+		}
+
+		L* life;			//the board iterated over
+		std::size_t cell;	//index in tiles of the cell pointed to, 0 for the end
+		int x;				//current row
+		int y;				//current column
+		int column;			//column within the tile, y % tile_size
+		int width;			//width of the board
+		int tile_size;		//width of a tile
+		std::size_t jump;	//from past the end of a tile row to the same row of the next tile
 	};
 
-	// 	-------------------------------------------------------
-	//	Nested Class const_iterator, it will iterate over board
-	//	-------------------------------------------------------
-	template <class T2>
-	class const_iterator {
-	public:
+	typedef basic_iterator<TiledLife, T> iterator;
+	typedef basic_iterator<const TiledLife, const T> const_iterator;
+
+	/**
+	 * @return an iterator to the first cell
+	 */
+	iterator begin() {
+		return iterator(*this, 0);
+	}
+
+	/**
+	 * @return an iterator to the first cell
+	 */
+	const_iterator begin() const {
+		return const_iterator(*this, 0);
+	}
+
+	/**
+	 * @return an iterator one past the last cell
+	 */
+	iterator end() {
+		return iterator(*this, static_cast<long long>(height) * width);
+	}
+
+	/**
+	 * @return an iterator one past the last cell
+	 */
+	const_iterator end() const {
+		return const_iterator(*this, static_cast<long long>(height) * width);
+	}
+
+private:
+	/*	Tile t holds rows (t / tile_columns) * tile_size on and columns
+	 *	(t % tile_columns) * tile_size on, stored row by row with a ring of one
+	 *	cell around them, stride cells per row, stride * stride per tile.
+	 */
+
+	/**
+	 * where cell (x, y) lives in tiles
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return the index
+	 */
+	std::size_t index(int x, int y) const {
+		const int t = (x / tile_size) * tile_columns + y / tile_size;
+		return static_cast<std::size_t>(t) * stride * stride + (x % tile_size + 1) * stride + y % tile_size + 1;
+	}
+
+	/**
+	 * throw std::out_of_range unless (x, y) is on the board
+	 */
+	void check(int x, int y) const {
+		if (x < 0 || x >= height || y < 0 || y >= width)
+			throw std::out_of_range("TiledLife::at");
+	}
+
+	/**
+	 * copy the edge cells of the tiles around a tile into its halo; halo cells
+	 * past the edge of the board have no tile to copy from and keep the borders
+	 * set up at construction
+	 * @param t the index of the tile
+	 */
+	void fill_halo(int t) {
+		const int r = t / tile_columns;
+		const int c = t % tile_columns;
+		const int s = tile_size;
+		const std::size_t area = static_cast<std::size_t>(stride) * stride;
+		T* cells = &tiles[t * area];
+
+		const bool up = r > 0;
+		const bool down = r + 1 < tile_rows;
+		const bool left = c > 0;
+		const bool right = c + 1 < tile_columns;
+
+		if (up) {
+			const T* above = &tiles[(t - tile_columns) * area];
+			std::copy(above + s * stride + 1, above + s * stride + 1 + s, cells + 1);
+		}
+		if (down) {
+			const T* below = &tiles[(t + tile_columns) * area];
+			std::copy(below + stride + 1, below + stride + 1 + s, cells + (s + 1) * stride + 1);
+		}
+		if (left) {
+			const T* before = &tiles[(t - 1) * area];
+			for (int i = 1; i < s + 1; i++)
+				cells[i * stride] = before[i * stride + s];
+		}
+		if (right) {
+			const T* after = &tiles[(t + 1) * area];
+			for (int i = 1; i < s + 1; i++)
+				cells[i * stride + s + 1] = after[i * stride + 1];
+		}
+
+		if (up && left)
+			cells[0] = tiles[(t - tile_columns - 1) * area + s * stride + s];
+		if (up && right)
+			cells[s + 1] = tiles[(t - tile_columns + 1) * area + s * stride + 1];
+		if (down && left)
+			cells[(s + 1) * stride] = tiles[(t + tile_columns - 1) * area + stride + s];
+		if (down && right)
+			cells[(s + 1) * stride + s + 1] = tiles[(t + tile_columns + 1) * area + stride + 1];
+	}
+
+	/**
+	 * evolve the cells of a tile into the back buffer
+	 * @param t the index of the tile
+	 * @return the population of the tile in the next generation
+	 */
+	int evolve_tile(int t) {
+		const int rows = std::min(tile_size, height - (t / tile_columns) * tile_size);
+		const int columns = std::min(tile_size, width - (t % tile_columns) * tile_size);
+		const std::size_t base = static_cast<std::size_t>(t) * stride * stride;
+
+		int count = 0;
+		for (int i = 1; i < rows + 1; i++) {
+			for (int j = 1; j < columns + 1; j++) {
+				const std::size_t k = base + i * stride + j;
+
+				T& new_cell = next_tiles[k];
+				new_cell = tiles[k] + Neighborhood<T>(&tiles[k], offsets);
+
+				if (new_cell.is_alive())
+					count++;
+			}
+		}
+
+		return count;
+	}
+
+	int height;			//max height
+	int width;			//max width
+	int tile_size;		//width and height of a tile
+	int tile_rows;		//tiles down the board
+	int tile_columns;	//tiles across the board
+	int stride;			//cells per row of a tile, halo included
+
+	std::vector<T> tiles;		//every tile, one after another
+	std::vector<T> next_tiles;	//back buffer the next generation is written to
+	std::ptrdiff_t offsets[8];	//offset from a cell in a tile to each of its neighbors
+	std::string frame;			//the last frame printed
+
+	int generation;			//generation tracker
+	int population;			//population tracker
+};
+
+// 	-------------------------------------------------------------------------
+//	Generic Class DistributedLife splits the board into strips of rows, each
+//	played by a worker process of its own. After every generation a worker
+//	hands the edge rows of its strip to its neighbors through shared memory,
+//	and they all meet at a barrier before reading them. The process that
+//	made the board only sums up the populations, asks the workers for cells
+//	and frames, and finds out when one of them dies. The cells themselves
+//	are spread over the workers, but the text of the board stays in shared
+//	memory mapped by every process, and print() builds a whole frame in the
+//	parent, so the parent still needs O(height * width) bytes.
+// 	-------------------------------------------------------------------------
+template <class T>
+class DistributedLife {
+public:
+
+	/**
+	 * constructor, forks the workers, throws std::runtime_error if the
+	 * shared memory or a worker cannot be made
+	 * @param in the istream to read from, same format as Life<T>
+	 * @param h is the height of the board
+	 * @param w is the width of the board
+	 * @param workers the number of worker processes, no more than h are used
+	 */
+	DistributedLife(std::istream& in, int h, int w, int workers) : processes(nullptr) {
+		assert(h >= 0 && w >= 0 && workers > 0);
+
+		height = h;
+		width = w;
+		strips = std::max(1, std::min(workers, h));
+		generation = 0;
+		population = 0;
+		failed = false;
+
+		const std::size_t cells = static_cast<std::size_t>(2) * strips * 2 * width;
+		memory.reset(new SharedMemory(sizeof(Control) + strips * sizeof(int) + cells * sizeof(SharedCell) + static_cast<std::size_t>(height) * (width + 1)));
+		control = new (memory->data()) Control(strips + 1);
+		populations = reinterpret_cast<int*>(memory->data() + sizeof(Control));
+		edges = reinterpret_cast<SharedCell*>(populations + strips);
+		rows = reinterpret_cast<char*>(edges + cells);
+
+		// the text stays in shared memory for the workers to build their strips from
+		std::string row;
+		int x = 0;
+		while (std::getline(in, row) && !row.empty()) {
+			if (x >= height)
+				throw std::runtime_error("board has more than " + std::to_string(height) + " rows");
+			if (static_cast<int>(row.size()) != width)
+				throw std::runtime_error("row " + std::to_string(x) + " is " + std::to_string(row.size()) + " cells wide, not " + std::to_string(width));
+
+			char* r = rows + static_cast<std::size_t>(x) * (width + 1);
+			for (int y = 0; y < width; y++) {
+				r[y] = row[y];
+				if (T(row[y]).is_alive())
+					population++;
+			}
+			r[width] = '\n';
+			x++;
+		}
+
+		if (x != height)
+			throw std::runtime_error("board has " + std::to_string(x) + " rows, not " + std::to_string(height));
+
+		processes.reset(new ProcessGroup(strips, [this] (int i) { serve(i); }));
+	}
+
+	/**
+	 * destructor, stops the workers
+	 */
+	~DistributedLife() {
+		if (!failed) {
+			control->command = QUIT;
+			control->barrier.wait(healthy());
+			processes->join();
+		}
+		processes.reset();
+		control->~Control();
+	}
+
+	/**
+	 * evolve the whole board one generation
+	 */
+	void evolve_all() {
+		evolve_n(1);
+	}
+
+	/**
+	 * evolve the whole board some generations, throws std::runtime_error if
+	 * a worker dies on the way
+	 * @param count the number of generations
+	 */
+	void evolve_n(int count) {
+		assert(count >= 0);
+		command(EVOLVE, count, 0, 0);
+
+		population = 0;
+		for (int i = 0; i < strips; i++)
+			population += populations[i];
+		generation += count;
+	}
+
+	/**
+	 * print the board, same format as Life<T>::print()
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out) {
+		command(RENDER, 0, 0, 0);
+
+		char* r = begin_frame(frame, generation, population, height, width);
+		std::memcpy(r, rows, static_cast<std::size_t>(height) * (width + 1));
+
+		out.write(frame.data(), frame.size());
+		out.flush();
+	}
+
+	/**
+	 * fetch the cell at position (x, y) from the worker that has it, throws
+	 * std::out_of_range outside of the board
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return a copy of the cell at position (x,y)
+	 */
+	T at(int x, int y) {
+		if (x < 0 || x >= height || y < 0 || y >= width)
+			throw std::out_of_range("DistributedLife::at");
+
+		command(AT, 0, x, y);
+
+		const SharedCell& c = control->cell;
+		return CellTraits<T>::make(c.species, c.alive != 0, c.age);
+	}
+
+	/**
+	 * @return the number of generations played
+	 */
+	int get_generation() const {
+		return generation;
+	}
+
+	/**
+	 * @return the number of live cells on the whole board
+	 */
+	int get_population() const {
+		return population;
+	}
+
+	/**
+	 * @param i the index of a strip
+	 * @return the process id of the worker that plays it
+	 */
+	pid_t worker(int i) const {
+		return processes->pid(i);
+	}
+
+private:
+	enum Command {EVOLVE, RENDER, AT, QUIT};
+
+	/*	Everything the processes share, the text of the board comes last:
+	 *	Control, int populations[strips],
+	 *	SharedCell edges[2 parities][strips][top, bottom][width],
+	 *	char rows[height * (width + 1)]
+	 */
+	struct Control {
+		explicit Control(int parties) : barrier(parties), command(QUIT), count(0), x(0), y(0), cell() {}
+
+		SharedBarrier barrier;	//every worker and the process that made the board
+		int command;			//what the workers do next
+		int count;				//generations to evolve
+		int x;					//cell to fetch
+		int y;
+		SharedCell cell;		//the cell fetched
+	};
+
+	/**
+	 * have the workers carry out a command and wait until they are done,
+	 * throws std::runtime_error if one of them died
+	 */
+	void command(Command c, int count, int x, int y) {
+		if (failed)
+			throw std::runtime_error("DistributedLife: a worker has failed");
+
+		control->command = c;
+		control->count = count;
+		control->x = x;
+		control->y = y;
+
+		// one meeting to start, one per generation, one when done
+		const int meetings = (c == EVOLVE) ? count + 2 : 2;
+		for (int i = 0; i < meetings; i++) {
+			if (!control->barrier.wait(healthy())) {
+				failed = true;
+				const int dead = processes->exited();
+				processes->kill_all();
+				throw std::runtime_error("DistributedLife: worker " + std::to_string(dead) + " has failed");
+			}
+		}
+	}
+
+	/**
+	 * @return a check that every worker is still running
+	 */
+	std::function<bool()> healthy() {
+		return [this] { return processes->exited() < 0; };
+	}
+
+	/**
+	 * @return where the edges of strip i go in the generation of parity p
+	 */
+	SharedCell* edge(int p, int i, bool bottom) const {
+		return edges + ((static_cast<std::size_t>(p) * strips + i) * 2 + bottom) * width;
+	}
+
+	/**
+	 * the loop of a worker, in its own process, until QUIT or the barrier breaks
+	 * @param i the index of the strip the worker plays
+	 */
+	void serve(int i) {
+		const int first = static_cast<int>(static_cast<long long>(i) * height / strips);
+		const int last = static_cast<int>(static_cast<long long>(i + 1) * height / strips);
+		const int n = last - first;
+		const std::ptrdiff_t s = width + 2;
+		const std::ptrdiff_t o[8] = {-1, s, 1, -s, s - 1, s + 1, -s + 1, -s - 1};
+
+		// rows 0 and n + 1 are the halo, borders above and below the board
+		std::vector<T> board(static_cast<std::size_t>(n + 2) * s, T(true));
+		for (int x = 0; x < n; x++)
+			for (int y = 0; y < width; y++)
+				board[(x + 1) * s + y + 1] = T(rows[static_cast<std::size_t>(first + x) * (width + 1) + y]);
+		std::vector<T> next_board = board;
+
+		int parity = 0;
+		while (control->barrier.wait()) {
+			switch (control->command) {
+			case EVOLVE:
+				for (int g = 0; g < control->count; g++) {
+					publish(&board[s + 1], edge(parity, i, false));
+					publish(&board[n * s + 1], edge(parity, i, true));
+
+					if (!control->barrier.wait())
+						return;
+
+					if (i > 0)
+						collect(edge(parity, i - 1, true), &board[1]);
+					if (i < strips - 1)
+						collect(edge(parity, i + 1, false), &board[(n + 1) * s + 1]);
+
+					int count = 0;
+					for (int x = 1; x < n + 1; x++) {
+						for (int y = 1; y < width + 1; y++) {
+							const std::size_t k = x * s + y;
+							T& new_cell = next_board[k];
+							new_cell = board[k] + Neighborhood<T>(&board[k], o);
+							if (new_cell.is_alive())
+								count++;
+						}
+					}
+
+					board.swap(next_board);
+					populations[i] = count;
+					parity ^= 1;
+				}
+				break;
+
+			case RENDER:
+				for (int x = 0; x < n; x++)
+					for (int y = 0; y < width; y++)
+						rows[static_cast<std::size_t>(first + x) * (width + 1) + y] = board[(x + 1) * s + y + 1].symbol();
+				break;
+
+			case AT:
+				if (control->x >= first && control->x < last) {
+					const T& c = board[(control->x - first + 1) * s + control->y + 1];
+					control->cell.age = CellTraits<T>::age(c);
+					control->cell.species = CellTraits<T>::species(c);
+					control->cell.alive = c.is_alive();
+				}
+				break;
+
+			default:
+				return;
+			}
+
+			if (!control->barrier.wait())
+				return;
+		}
+	}
+
+	/**
+	 * copy a row of cells into shared memory
+	 */
+	void publish(const T* from, SharedCell* to) const {
+		for (int y = 0; y < width; y++) {
+			to[y].age = CellTraits<T>::age(from[y]);
+			to[y].species = CellTraits<T>::species(from[y]);
+			to[y].alive = from[y].is_alive();
+		}
+	}
+
+	/**
+	 * copy a row of cells out of shared memory
+	 */
+	void collect(const SharedCell* from, T* to) const {
+		for (int y = 0; y < width; y++)
+			to[y] = CellTraits<T>::make(from[y].species, from[y].alive != 0, from[y].age);
+	}
+
+	int height;			//max height
+	int width;			//max width
+	int strips;			//number of workers
+
+	std::unique_ptr<SharedMemory> memory;		//everything shared with the workers
+	Control* control;							//the start of memory
+	int* populations;							//population of every strip
+	SharedCell* edges;							//edge rows of every strip
+	char* rows;									//the board as text
+	std::unique_ptr<ProcessGroup> processes;	//the workers
+	std::string frame;							//the last frame printed
+
+	int generation;		//generation tracker
+	int population;		//population tracker
+	bool failed;		//true once a worker has died
+};
+
+// 	-------------------------------------------------------------------------
+//	Generic Class StreamLife evolves a board read row by row and writes the
+//	rows of a later generation as soon as they are known, so the board is
+//	never in memory whole. Every generation played keeps a window of the
+//	three rows it needs around the row it evolves, and hands each row it
+//	finishes to the window of the next generation.
+// 	-------------------------------------------------------------------------
+template <class T>
+class StreamLife {
+public:
 
-		/**
-		 * constructor
-	 	 * @param l is the life instance to iterate over
-	 	 * @param x the horizontal variable (without borders as they are hidden from the user)
-	 	 * @param y the vertical variable (without borders as they are hidden from the user)
-		 */	
-		const_iterator(const Life& l, int x_, int y_) : life(l), x(x_), y(y_) {}
+	/**
+	 * constructor
+	 * @param g the number of generations every pass plays, each one keeps a window of three rows
+	 */
+	explicit StreamLife(int g) : generations(g), height(0), width(0), generation(0), population(0), sink(nullptr) {
+		assert(g >= 0);
+	}
 
-		/**
-		 * operator * will override the * operator for const_iterator
-	 	 * @return a reference to the cell this iterator points to
-		 */	
-		const T2& operator*() const {
-			return life.at(x, y);
-		}
+	/**
+	 * read a board and write the rows of the board generations later, without
+	 * the header and the blank line that print() writes around them. The
+	 * board is either what print() writes, header included, or rows alone,
+	 * and ends with a blank line or the end of the stream. Throws
+	 * std::runtime_error if the rows are not all the same width
+	 * @param in the istream to read from
+	 * @param out the ostream to write the rows to
+	 * @return the population of the board written
+	 */
+	unsigned long long evolve(std::istream& in, std::ostream& out) {
+		height = 0;
+		width = -1;
+		generation = 0;
+		population = 0;
+		sink = &out;
 
-		/**
-		 * operator ++ will override the ++ operator for const_iterator and will iterate to the next element 
-	 	 * @return a reference to the iterator pointing to the next element
-		 */	
-		const_iterator<T2>& operator++() {
-			y++;
-			if (y >= life.width) {
-				x++;
-				y = 0;
+		std::string row;
+		while (std::getline(in, row) && !row.empty()) {
+			if (width < 0 && height == 0 && generation == 0 && row.compare(0, 13, "Generation = ") == 0) {
+				generation = std::strtoull(row.c_str() + 13, nullptr, 10);
+				continue;
 			}
-			return *this;
+
+			if (width < 0)
+				start(static_cast<int>(row.size()));
+			else if (static_cast<int>(row.size()) != width)
+				throw std::runtime_error("StreamLife: row " + std::to_string(height) + " is not " + std::to_string(width) + " cells wide");
+
+			T* cells = slot(0, height);
+			for (int y = 0; y < width; y++)
+				cells[y] = T(row[y]);
+			arrive(0, height);
+			height++;
 		}
 
-		/**
-		 * operator -- will override the -- operator for const_iterator and will iterate to the previous element 
-	 	 * @return a reference to the iterator pointing to the previous element
-		 */	
-		const_iterator<T2>& operator--() {
-			y--;
-			if (y < 0) {
-				x--;
-				y = life.width - 1;
+		// the last row of every generation has the border below it
+		if (height > 0)
+			for (int j = 0; j < generations; j++)
+				step(j, height - 1, border(j));
+
+		width = std::max(width, 0);
+		generation += generations;
+		sink = nullptr;
+		return population;
+	}
+
+	/**
+	 * evolve the board in one file into another, written the way print()
+	 * writes it. The rows go to a file next to the new one first, as the
+	 * header needs the population, and the new file replaces any old one
+	 * once it is complete, so from and to may be the same file. Throws
+	 * std::runtime_error if a file cannot be read or written
+	 * @param from the file to read
+	 * @param to the file to write
+	 */
+	void evolve(const std::string& from, const std::string& to) {
+		std::ifstream in(from.c_str());
+		if (!in)
+			throw std::runtime_error("cannot open " + from);
+
+		const std::string rows = to + ".rows";
+		try {
+			{
+				std::ofstream out(rows.c_str(), std::ios::binary);
+				if (!out)
+					throw std::runtime_error("cannot write " + rows);
+				evolve(in, out);
+				if (!out.flush())
+					throw std::runtime_error("cannot write " + rows);
 			}
-			return *this;
-		}
 
-		/**
-		 * operator == will override the == operator for const_iterator
-	 	 * @return a bool with the value of the comparison
-		 */
-		bool operator==(const const_iterator<T2>& rhs) const {
-			return x == rhs.x && y == rhs.y && &life == &rhs.life;
+			write_frame_file(to, rows, generation, population);
 		}
-
-		/**
-		 * operator != will override the != operator for const_iterator
-	 	 * @return a bool with the value of the comparison
-		 */	
-		bool operator!=(const const_iterator<T2>& rhs) const {
-			return !(*this == rhs);
+		catch (...) {
+			// as big as the board, never leave it behind
+			std::remove(rows.c_str());
+			throw;
 		}
-	private:
-		const Life<T2>& life;		//the board that will be iterated over
-		int x;						//current x
-		int y;						//current y
-	};
+	}
 
-	/*
-	 * return the first element in board
-	 * @return the first element in board
+	/**
+	 * @return the generation of the board written last, the one read plus the generations played
 	 */
-	iterator<T> begin() {
-		return iterator<T>(*this, 0, 0);
+	unsigned long long get_generation() const {
+		return generation;
 	}
 
-	/*
-	 * return the first element in board
-	 * @return the first element in board
+	/**
+	 * @return the population of the board written last
 	 */
-	const_iterator<T> begin() const {
-		return const_iterator<T>(*this, 0, 0);
+	unsigned long long get_population() const {
+		return population;
 	}
 
-	/*
-	 * return the last element in board
-	 * @return the last element in board
+	/**
+	 * @return the height of the board read last
 	 */
-	iterator<T> end() {
-		return iterator<T>(*this, height - 1, width);
+	int get_height() const {
+		return height;
 	}
 
-	/*
-	 * return the last element in board
-	 * @return the last element in board
+	/**
+	 * @return the width of the board read last
 	 */
-	const_iterator<T> end() const {
-		return const_iterator<T>(*this, height - 1, width);
+	int get_width() const {
+		return width;
+	}
+
+private:
+	/*	Every generation j has a block of four rows of width + 2 cells in
+	 *	windows: row n of the board sits in row n % 3 of the block, the fourth
+	 *	is all borders. Block generations only holds the row being written.
+	 */
+
+	/**
+	 * size the windows for a board
+	 * @param w the width of the board
+	 */
+	void start(int w) {
+		width = w;
+		windows.assign(static_cast<std::size_t>(generations + 1) * 4 * (width + 2), T(true));
+		line.assign(width + 1, '\n');
+	}
+
+	/**
+	 * @return the first cell of row n in the window of generation j
+	 */
+	T* slot(int j, int n) {
+		return &windows[(static_cast<std::size_t>(j) * 4 + n % 3) * (width + 2) + 1];
+	}
+
+	/**
+	 * @return the first cell of the row of borders of generation j
+	 */
+	T* border(int j) {
+		return &windows[(static_cast<std::size_t>(j) * 4 + 3) * (width + 2) + 1];
+	}
+
+	/**
+	 * row n of generation j has arrived, so row n - 1 has both its neighbors
+	 */
+	void arrive(int j, int n) {
+		if (j == generations) {
+			write(slot(j, n));
+			return;
+		}
+
+		if (n > 0)
+			step(j, n - 1, slot(j, n));
+	}
+
+	/**
+	 * evolve row n of generation j into the window of generation j + 1
+	 * @param below the row under it
+	 */
+	void step(int j, int n, const T* below) {
+		const T* above = (n > 0) ? slot(j, n - 1) : border(j);
+		const T* cells = slot(j, n);
+		T* next = slot(j + 1, n);
+
+		const std::ptrdiff_t up = above - cells;
+		const std::ptrdiff_t down = below - cells;
+		const std::ptrdiff_t o[8] = {-1, down, 1, up, down - 1, down + 1, up + 1, up - 1};
+
+		for (int y = 0; y < width; y++)
+			next[y] = cells[y] + Neighborhood<T>(&cells[y], o);
+
+		arrive(j + 1, n);
 	}
+
+	/**
+	 * write a row of the last generation
+	 */
+	void write(const T* cells) {
+		for (int y = 0; y < width; y++) {
+			line[y] = cells[y].symbol();
+			if (cells[y].is_alive())
+				population++;
+		}
+		sink->write(line.data(), line.size());
+	}
+
+	int generations;	//generations played by every pass
+	int height;			//rows read so far
+	int width;			//width of the board, -1 before the first row
+
+	std::vector<T> windows;		//three rows and a row of borders for every generation
+	std::string line;			//the row being written
+
+	unsigned long long generation;		//generation tracker
+	unsigned long long population;		//population tracker
+	std::ostream* sink;					//where the rows go
+};
+
+// 	--------------------------------------------------------------------
+//	Class ConwayLife is a bit-packed board that only plays Conway's rules
+// 	--------------------------------------------------------------------
+class ConwayLife {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if a row is not w wide, the
+	 * board does not have h rows or a symbol is not '*' or '.'
+	 * @param in the istream to read from
+	 * @param h is the height of the board
+	 * @param w is the width of the board
+	 */
+	ConwayLife(std::istream& in, int h, int w);
+
+	/**
+	 * print the board, same format as Life<ConwayCell>::print()
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out);
+
+	/**
+	 * evolve the whole board one generation, 64 cells per word at a time
+	 */
+	void evolve_all();
+
+	/**
+	 * will retrieve the cell at position (x, y) in the board
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return a copy of the cell at position (x,y)
+	 */
+	const ConwayCell at(int x, int y) const;
+
 private:
+	/*	One bit per cell, bit j of word k in a row is column 64 * (k - 1) + j.
+	 *	Every row is padded with an empty word on both sides and the board with
+	 *	an empty row on top and bottom, so the kernel never checks bounds.
+	 */
+
+	/**
+	 * is the bit for cell (x, y) set?
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return true if the cell is alive
+	 */
+	bool get(int x, int y) const;
+
+	/**
+	 * set the bit for cell (x, y)
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @param alive the new state of the cell
+	 */
+	void set(int x, int y, bool alive);
+
 	int height;			//max height
 	int width;			//max width
-	std::vector<T> board;	//the board itself
+	int stride;			//words per row, including the two padding words
+	std::uint64_t last_mask;	//valid bits of the last word of every row
+
+	std::vector<std::uint64_t> cells;	//current generation
+	std::vector<std::uint64_t> next;	//back buffer for the next generation
+	std::string frame;					//the last frame printed
 
 	int generation;			//generation tracker
 	int population;			//population tracker
+};
 
-	FRIEND_TEST(LifeFixture, life_construct1);
-	FRIEND_TEST(LifeFixture, life_construct2);
-	FRIEND_TEST(LifeFixture, life_construct3);
+// 	-------------------------------------------------------------------------
+//	Class FredkinLife plays Fredkin's rules, same as Life<FredkinCell>, on
+//	separate planes of alive bytes and ages instead of an array of cells, and
+//	only ever reads the 4 orthogonal neighbors
+// 	-------------------------------------------------------------------------
+class FredkinLife {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if a row is not w wide or the
+	 * board does not have h rows
+	 * @param in the istream to read from
+	 * @param h is the height of the board
+	 * @param w is the width of the board
+	 */
+	FredkinLife(std::istream& in, int h, int w);
+
+	/**
+	 * print the board, same format as Life<FredkinCell>::print()
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out);
+
+	/**
+	 * evolve the whole board one generation
+	 */
+	void evolve_all();
+
+	/**
+	 * will retrieve the cell at position (x, y) in the board
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return a copy of the cell at position (x,y)
+	 */
+	const FredkinCell at(int x, int y) const;
+
+private:
+	/*	Both planes are padded with a dead border, cell (x, y) lives at
+	 *	(x + 1) * (width + 2) + y + 1, so the kernel never checks bounds.
+	 */
+
+	int height;			//max height
+	int width;			//max width
+
+	std::vector<std::uint8_t> alive;		//1 for a live cell, current generation
+	std::vector<std::uint8_t> next_alive;	//back buffer for the next generation
+	std::vector<int> ages;					//age of every cell, current generation
+	std::vector<int> next_ages;				//back buffer for the next generation
+	std::string frame;						//the last frame printed
+
+	int generation;			//generation tracker
+	int population;			//population tracker
+};
+
+// 	-------------------------------------------------------------------------
+//	Class MixedLife plays a board of conway and fredkin cells, same as
+//	Life<Cell>, on separate planes of species tags, alive bytes and ages, and
+//	picks the rule of every cell by its tag instead of a virtual call
+// 	-------------------------------------------------------------------------
+class MixedLife {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if a row is not w wide or the
+	 * board does not have h rows
+	 * @param in the istream to read from
+	 * @param h is the height of the board
+	 * @param w is the width of the board
+	 */
+	MixedLife(std::istream& in, int h, int w);
+
+	/**
+	 * print the board, same format as Life<Cell>::print()
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out);
+
+	/**
+	 * evolve the whole board one generation, a fredkin cell about to turn 2
+	 * becomes a live conway cell instead
+	 */
+	void evolve_all();
+
+	/**
+	 * will retrieve the cell at position (x, y) in the board
+	 * @param x the horizontal variable
+	 * @param y the vertical variable
+	 * @return a copy of the cell at position (x,y)
+	 */
+	const Cell at(int x, int y) const;
+
+private:
+	/*	Every plane is padded with a dead border, cell (x, y) lives at
+	 *	(x + 1) * (width + 2) + y + 1, so the kernel never checks bounds.
+	 */
+
+	int height;			//max height
+	int width;			//max width
+
+	std::vector<std::uint8_t> species;		//CONWAY or FREDKIN, current generation
+	std::vector<std::uint8_t> next_species;	//back buffer for the next generation
+	std::vector<std::uint8_t> alive;		//1 for a live cell, current generation
+	std::vector<std::uint8_t> next_alive;	//back buffer for the next generation
+	std::vector<int> ages;					//age of every fredkin cell, 0 for a conway cell
+	std::vector<int> next_ages;				//back buffer for the next generation
+	std::string frame;						//the last frame printed
+
+	int generation;			//generation tracker
+	int population;			//population tracker
+};
+
+// 	-------------------------------------------------------------------------
+//	Class HashLife plays Conway's rules on a memoized quadtree of shared nodes
+//	so it can jump far ahead. Unlike Life<ConwayCell> the plane has no border,
+//	the board read in is a window at (0, 0) and print() shows that window.
+// 	-------------------------------------------------------------------------
+class HashLife {
+public:
+
+	/**
+	 * constructor, throws std::runtime_error if a row is not w wide, the
+	 * window does not have h rows or a symbol is not '*' or '.'
+	 * @param in the istream to read from, same format as Life<ConwayCell>
+	 * @param h is the height of the window
+	 * @param w is the width of the window
+	 */
+	HashLife(std::istream& in, int h, int w);
+
+	/**
+	 * print the window, same format as Life<ConwayCell>::print(), the
+	 * population counts the whole plane
+	 * @param out the ostream to write to
+	 */
+	void print(std::ostream& out);
+
+	/**
+	 * evolve the plane, throws std::overflow_error from 2^61 generations on,
+	 * the plane could no longer be addressed with long long coordinates
+	 * @param generations how many generations to move forward
+	 */
+	void advance(unsigned long long generations);
+
+	/**
+	 * evolve the plane up to a generation, throws std::invalid_argument if
+	 * the target is before the current generation
+	 * @param target the generation to reach
+	 */
+	void jump_to(unsigned long long target);
+
+	/**
+	 * will retrieve the cell at position (x, y) of the plane
+	 * @param x the horizontal variable, may be outside the window
+	 * @param y the vertical variable, may be outside the window
+	 * @return a copy of the cell at position (x,y)
+	 */
+	const ConwayCell at(long long x, long long y) const;
+
+	/**
+	 * bound the node cache, unreachable nodes are collected when it fills
+	 * @param nodes the number of nodes kept before collecting
+	 */
+	void set_cache_limit(std::size_t nodes);
+
+private:
+	/*	Leaves are the nodes 0 (dead) and 1 (alive), a node of level k is a
+	 *	square of side 2^k made of four nodes of level k - 1.
+	 */
+	struct Node {
+		std::uint32_t nw, ne, sw, se;	//quadrants, unused for leaves
+		int level;						//log2 of the side
+		unsigned long long population;	//live cells in the square
+		std::uint32_t result;			//memoized center after 2^result_step generations
+		int result_step;				//-1 when nothing is memoized
+	};
+
+	struct Key {
+		std::uint32_t nw, ne, sw, se;
+		bool operator==(const Key& rhs) const {
+			return nw == rhs.nw && ne == rhs.ne && sw == rhs.sw && se == rhs.se;
+		}
+	};
+
+	struct KeyHash {
+		std::size_t operator()(const Key& k) const {
+			std::uint64_t h = k.nw;
+			h = h * 0x9E3779B97F4A7C15ULL + k.ne;
+			h = h * 0x9E3779B97F4A7C15ULL + k.sw;
+			h = h * 0x9E3779B97F4A7C15ULL + k.se;
+			return static_cast<std::size_t>(h ^ (h >> 29));
+		}
+	};
+
+	/**
+	 * find or make the node with these quadrants
+	 * @return the shared node
+	 */
+	std::uint32_t join(std::uint32_t nw, std::uint32_t ne, std::uint32_t sw, std::uint32_t se);
+
+	/**
+	 * the empty node of a level
+	 * @param level the level
+	 * @return the shared empty node
+	 */
+	std::uint32_t empty(int level);
+
+	/**
+	 * the center of node n, one level down
+	 */
+	std::uint32_t center(std::uint32_t n);
+
+	/**
+	 * the center of node n one level down, after 2^min(step, level - 2) generations
+	 * @param n a node of level 2 or more
+	 * @param step log2 of the generations wanted
+	 */
+	std::uint32_t successor(std::uint32_t n, int step);
+
+	/**
+	 * one generation of the center 2x2 of a level 2 node
+	 */
+	std::uint32_t successor_leaf(std::uint32_t n);
+
+	/**
+	 * build the node of a level covering part of the window
+	 */
+	std::uint32_t build(const std::vector<char>& cells, int level, long long x0, long long y0);
+
+	/**
+	 * grow the root by one level, keeping the plane centered, throws
+	 * std::overflow_error past the largest level long long can address
+	 */
+	void expand();
+
+	/**
+	 * is everything alive within the center half of the root?
+	 */
+	bool centered() const;
+
+	/**
+	 * advance the plane 2^step generations, throws std::overflow_error if
+	 * the root would have to grow past the largest level
+	 */
+	void step(int step);
+
+	/**
+	 * drop the memoized results and the nodes the root cannot reach
+	 */
+	void collect();
+
+	/**
+	 * mark n and everything below it
+	 */
+	void mark(std::uint32_t n, std::vector<char>& live) const;
+
+	/**
+	 * write the live cells of n into the window
+	 */
+	void render(std::uint32_t n, long long x0, long long y0, std::vector<char>& cells) const;
+
+	int height;			//height of the window
+	int width;			//width of the window
+
+	std::vector<Node> nodes;	//every node, indexed by id
+	std::unordered_map<Key, std::uint32_t, KeyHash> table;	//quadrants to node
+	std::vector<std::uint32_t> empties;	//the empty node of every level so far
+	std::size_t cache_limit;	//nodes kept before collecting
+
+	std::uint32_t root;		//the plane
+	long long origin_x;		//row of the top left corner of root
+	long long origin_y;		//column of the top left corner of root
+
+	unsigned long long generation;		//generation tracker
+	std::string frame;					//the last frame printed
 };
 
 #endif
\ No newline at end of file
@@ -8,60 +8,76 @@
 // includes
 // --------
 
-#include <cassert>   // assert
-#include <iostream>  // cout, endl
+#include <algorithm> // max
+#include <iostream>  // cin, cout
+#include <string>    // getline, string
+#include <thread>    // hardware_concurrency
+#include <vector>    // vector
 
 #include "Life.h"
 
+// ----------
+// read_board
+// ----------
+
+/**
+ * read a board up to the blank line that ends it, or the end of the input
+ * @param in the istream to read from
+ * @return the board, every row ended by '\n'
+ */
+std::string read_board (std::istream& in) {
+    std::string board;
+    std::string row;
+    while (std::getline(in, row) && !row.empty())
+        board += row + '\n';
+    return board;
+}
+
 // ----
 // main
 // ----
 
+/*
+Every board is an independent job, run_batch() runs them across the cores
+and writes their output in order, the same bytes as running them in turn.
+*/
+
 int main () {
     using namespace std;
 
+    vector<LifeJob> jobs;
+    vector<int> prints;
+
     // ----------------------
     // Life<ConwayCell> 21x13
     // ----------------------
 
-    cout << "*** Life<ConwayCell> 21x13 ***\n" << endl;
     /*
     Simulate 12 evolutions.
     Print every grid (i.e. 0, 1, 2, 3, ... 12)
     */
-    {
-        Life<ConwayCell> l1(cin, 21, 13);
-        l1.print(cout);
-        for (int i = 1; i <= 12; i++) {
-            l1.evolve_all();
-            l1.print(cout);
-        }
-    }
+    prints.clear();
+    for (int i = 0; i <= 12; i++)
+        prints.push_back(i);
+    jobs.push_back(LifeJob(CONWAY_CELLS, read_board(cin), 12, prints, "*** Life<ConwayCell> 21x13 ***\n\n"));
 
     // ----------------------
     // Life<ConwayCell> 20x29
     // ----------------------
 
-    cout << "*** Life<ConwayCell> 20x29 ***\n" << endl;
     /*
     Simulate 28 evolutions.
     Print every 4th grid (i.e. 0, 4, 8, ... 28)
     */
-    {
-        Life<ConwayCell> l2(cin, 20, 29);
-        l2.print(cout);
-        for (int i = 1; i <= 28; i++) {
-            l2.evolve_all();
-            if (i % 4 == 0)
-                l2.print(cout);
-        }
-    }
+    prints.clear();
+    for (int i = 0; i <= 28; i += 4)
+        prints.push_back(i);
+    jobs.push_back(LifeJob(CONWAY_CELLS, read_board(cin), 28, prints, "*** Life<ConwayCell> 20x29 ***\n\n"));
 
     // -----------------------
     // Life<ConwayCell> 109x69
     // -----------------------
 
-    cout << "*** Life<ConwayCell> 109x69 ***\n" << endl;
     /*
     Simulate 283 evolutions.
     Print the first 10 grids (i.e. 0, 1, 2, ... 9).
@@ -71,51 +87,39 @@ int main () {
     Simulate 2177 evolutions.
     Print the 2500th grid.
     */
-    {
-        Life<ConwayCell> l3(cin, 109, 69);
-        l3.print(cout);
-        for (int i = 1; i <= 2500; i++) {
-            l3.evolve_all();
-            if (i < 10 || i == 283 || i == 323 || i == 2500)
-                l3.print(cout);
-        }
-    }
+    prints.clear();
+    for (int i = 0; i < 10; i++)
+        prints.push_back(i);
+    prints.push_back(283);
+    prints.push_back(323);
+    prints.push_back(2500);
+    jobs.push_back(LifeJob(CONWAY_CELLS, read_board(cin), 2500, prints, "*** Life<ConwayCell> 109x69 ***\n\n"));
+    jobs.back().cycle_history = 64;    // the board settles long before 2500, skip its cycles
 
     // -----------------------
     // Life<FredkinCell> 20x20
     // -----------------------
 
-    cout << "*** Life<FredkinCell> 20x20 ***\n" << endl;
     /*
     Simulate 5 evolutions.
     Print every grid (i.e. 0, 1, 2, ... 5)
     */
-    {
-        Life<FredkinCell> l4(cin, 20, 20);
-        l4.print(cout);
-        for (int i = 1; i <= 5; i++) {
-            l4.evolve_all();
-            l4.print(cout);
-        }
-    }
+    prints.clear();
+    for (int i = 0; i <= 5; i++)
+        prints.push_back(i);
+    jobs.push_back(LifeJob(FREDKIN_CELLS, read_board(cin), 5, prints, "*** Life<FredkinCell> 20x20 ***\n\n"));
 
     // ----------------
     // Life<Cell> 20x20
     // ----------------
 
-    cout << "*** Life<Cell> 20x20 ***\n" << endl;
     /*
     Simulate 5 evolutions.
     Print every grid (i.e. 0, 1, 2, ... 5)
     */
-    {
-        Life<Cell> l5(cin, 20, 20);
-        l5.print(cout);
-        for (int i = 1; i <= 5; i++) {
-            l5.evolve_all();
-            l5.print(cout);
-        }
-    }
+    jobs.push_back(LifeJob(MIXED_CELLS, read_board(cin), 5, prints, "*** Life<Cell> 20x20 ***\n\n"));
+
+    run_batch(jobs, max(1, static_cast<int>(thread::hardware_concurrency())), cout);
 
     return 0;
 }
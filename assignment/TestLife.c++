@@ -1,5 +1,18 @@
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <sstream>
+#include <thread>
 #include <vector>
+#if __cplusplus >= 201703L
+#include <execution>
+#endif
+
+#include <dirent.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "gtest/gtest.h"
 
@@ -317,7 +330,7 @@ TEST(CellFixture, cell_conway_copy_constructor1) {
 	ConwayCell cc = ConwayCell('*');
 	ASSERT_EQ(cc.is_alive(), true);
 
-	Cell c = Cell(&cc);
+	Cell c = Cell(cc);
 	ASSERT_EQ(c.acell->is_alive(), true);
 
 	Cell c2 = c;
@@ -329,7 +342,7 @@ TEST(CellFixture, cell_conway_copy_constructor2) {
 	ConwayCell cc = ConwayCell('.');
 	ASSERT_EQ(cc.is_alive(), false);
 
-	Cell c = Cell(&cc);
+	Cell c = Cell(cc);
 	ASSERT_EQ(c.acell->is_alive(), false);
 
 	Cell c2 = c;
@@ -344,10 +357,10 @@ TEST(CellFixture, cell_conway_copy_assignment1) {
 	ConwayCell cc2 = ConwayCell('.');
 	ASSERT_EQ(cc2.is_alive(), false);
 
-	Cell c = Cell(&cc);
+	Cell c = Cell(cc);
 	ASSERT_EQ(c.acell->is_alive(), true);
 
-	Cell c2 = Cell(&cc2);
+	Cell c2 = Cell(cc2);
 	ASSERT_EQ(c2.acell->is_alive(), false);
 
 	c2 = c;
@@ -362,10 +375,10 @@ TEST(CellFixture, cell_conway_copy_assignment2) {
 	ConwayCell cc2 = ConwayCell('*');
 	ASSERT_EQ(cc2.is_alive(), true);
 
-	Cell c = Cell(&cc);
+	Cell c = Cell(cc);
 	ASSERT_EQ(c.acell->is_alive(), false);
 
-	Cell c2 = Cell(&cc2);
+	Cell c2 = Cell(cc2);
 	ASSERT_EQ(c2.acell->is_alive(), true);
 
 	c2 = c;
@@ -374,6 +387,38 @@ TEST(CellFixture, cell_conway_copy_assignment2) {
 }
 
 
+TEST(CellFixture, cell_inline1) {
+	Cell c = Cell('*');
+	const char* p = reinterpret_cast<const char*>(c.acell);
+	ASSERT_GE(p, reinterpret_cast<const char*>(&c));
+	ASSERT_LT(p, reinterpret_cast<const char*>(&c + 1));
+
+	Cell c2 = c;
+	ASSERT_NE(c2.acell, c.acell);
+	ASSERT_EQ(c2.acell->is_alive(), true);
+}
+
+TEST(CellFixture, cell_fredkin_copy_assignment1) {
+	Cell c = Cell('5');
+	Cell c2 = Cell('.');
+
+	c2 = c;
+	c = Cell('*');
+	ASSERT_EQ(c2.acell->is_alive(), true);
+	ASSERT_EQ(static_cast<FredkinCell*>(c2.acell)->age(), 5);
+
+	c2 = c2;
+	ASSERT_EQ(static_cast<FredkinCell*>(c2.acell)->age(), 5);
+}
+
+TEST(CellFixture, cell_adopt1) {
+	Cell c = Cell(new FredkinCell(3, true));
+	Cell c2 = c;
+	c = Cell('.');
+	ASSERT_EQ(c2.acell->is_alive(), true);
+	ASSERT_EQ(c.acell->is_alive(), false);
+}
+
 class CellEvolutionFixture : public ::testing::TestWithParam<vector<char>> {
 	// Fixture for running tests of evolution. The argument is a vector containing the neighbors, then the value of the cell, then the expected value
 
@@ -761,6 +806,198 @@ TEST(LifeFixture, life_evolve_all5) {
 
 
 
+TEST(LifeFixture, life_evolve_all6) {
+	istringstream in(".....\n..*..\n..*..\n..*..\n.....\n\n");
+
+	Life<ConwayCell> l(in, 5, 5);
+
+	l.evolve_all();
+	l.evolve_all();
+	l.evolve_all();
+
+	ostringstream out;
+	l.print(out);
+	ASSERT_EQ(out.str(), "Generation = 3, Population = 3.\n.....\n.....\n.***.\n.....\n.....\n\n");
+
+	EXPECT_EQ(l.board.size(), (l.width + 2) * (l.height + 2));
+	EXPECT_EQ(l.board[0].is_border(), true);
+	EXPECT_EQ(l.board[l.board.size() - 1].is_border(), true);
+}
+
+TEST(LifeFixture, life_neighborhood1) {
+	istringstream in("-1-\n2-4\n+--\n\n");
+
+	Life<FredkinCell> l(in, 3, 3);
+
+	const ptrdiff_t s = l.width + 2;
+	const FredkinCell& c = l.at(1, 1);
+	Neighborhood<FredkinCell> n(&c, l.offsets);
+	ASSERT_EQ(n[0].age(), 2);	// (1, 0)
+	ASSERT_EQ(n[2].age(), 4);	// (1, 2)
+	ASSERT_EQ(n[3].age(), 1);	// (0, 1)
+	ASSERT_EQ(n[1].is_alive(), false);
+	ASSERT_EQ(&n[4], &c + s - 1);
+}
+
+TEST(LifeFixture, life_evolve_all_threads1) {
+	string board = "..........\n.***...*..\n.*....**..\n..*..*.*..\n..........\n.....***..\n..**......\n..**....*.\n.......**.\n..........\n\n";
+	istringstream in1(board);
+	istringstream in2(board);
+
+	Life<ConwayCell> serial(in1, 10, 10);
+	Life<ConwayCell> parallel(in2, 10, 10);
+	parallel.set_threads(4);
+
+	for (int i = 0; i < 20; i++) {
+		serial.evolve_all();
+		parallel.evolve_all();
+
+		ostringstream s1, s2;
+		serial.print(s1);
+		parallel.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+	}
+}
+
+TEST(LifeFixture, life_evolve_all_threads2) {
+	string board = "-0--3-\n-1--+-\n--2---\n5---9-\n------\n\n";
+	istringstream in1(board);
+	istringstream in2(board);
+
+	Life<FredkinCell> serial(in1, 5, 6);
+	Life<FredkinCell> parallel(in2, 5, 6);
+	parallel.set_threads(8);	// more threads than rows
+
+	for (int i = 0; i < 10; i++) {
+		serial.evolve_all();
+		parallel.evolve_all();
+	}
+
+	ostringstream s1, s2;
+	serial.print(s1);
+	parallel.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(LifeFixture, life_evolve_all_threads3) {
+	string board = ".*-5..\n*.+-*.\n-.19-*\n.-*-..\n0-.*1-\n\n";
+	istringstream in1(board);
+	istringstream in2(board);
+
+	Life<Cell> serial(in1, 5, 6);
+	Life<Cell> parallel(in2, 5, 6);
+	parallel.set_threads(3);
+
+	for (int i = 0; i < 10; i++) {
+		serial.evolve_all();
+		parallel.evolve_all();
+		if (i == 5)
+			parallel.set_threads(1);
+		if (i == 7)
+			parallel.set_threads(2);
+	}
+
+	ostringstream s1, s2;
+	serial.print(s1);
+	parallel.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(LifeFixture, life_evolve_all_tiles1) {
+	// a glider flying into a block, a blinker and empty space
+	string board;
+	for (int x = 0; x < 23; x++) {
+		string row(17, '.');
+		if (x == 1) row[2] = '*';
+		if (x == 2) row[3] = '*';
+		if (x == 3) { row[1] = '*'; row[2] = '*'; row[3] = '*'; }
+		if (x == 12 || x == 13) { row[11] = '*'; row[12] = '*'; }
+		if (x == 20) { row[5] = '*'; row[6] = '*'; row[7] = '*'; }
+		board += row + "\n";
+	}
+	board += "\n";
+
+	istringstream in1(board);
+	istringstream in2(board);
+	istringstream in3(board);
+
+	Life<ConwayCell> plain(in1, 23, 17);
+	Life<ConwayCell> tiled(in2, 23, 17);
+	Life<ConwayCell> threaded(in3, 23, 17);
+	tiled.set_tile_size(4);
+	threaded.set_tile_size(5);
+	threaded.set_threads(3);
+
+	for (int i = 0; i < 60; i++) {
+		plain.evolve_all();
+		tiled.evolve_all();
+		threaded.evolve_all();
+
+		ostringstream s1, s2, s3;
+		plain.print(s1);
+		tiled.print(s2);
+		threaded.print(s3);
+		ASSERT_EQ(s1.str(), s2.str());
+		ASSERT_EQ(s1.str(), s3.str());
+	}
+}
+
+TEST(LifeFixture, life_evolve_all_tiles2) {
+	string board = "-0--3-\n-1--+-\n--2---\n5---9-\n------\n\n";
+	istringstream in1(board);
+	istringstream in2(board);
+
+	Life<FredkinCell> plain(in1, 5, 6);
+	Life<FredkinCell> tiled(in2, 5, 6);
+	tiled.set_tile_size(2);
+
+	for (int i = 0; i < 10; i++) {
+		plain.evolve_all();
+		tiled.evolve_all();
+	}
+
+	ostringstream s1, s2;
+	plain.print(s1);
+	tiled.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(LifeFixture, life_evolve_all_tiles3) {
+	string board = ".*-5..\n*.+-*.\n-.19-*\n.-*-..\n0-.*1-\n\n";
+	istringstream in1(board);
+	istringstream in2(board);
+
+	Life<Cell> plain(in1, 5, 6);
+	Life<Cell> tiled(in2, 5, 6);
+	tiled.set_tile_size(3);
+
+	for (int i = 0; i < 10; i++) {
+		plain.evolve_all();
+		tiled.evolve_all();
+	}
+
+	ostringstream s1, s2;
+	plain.print(s1);
+	tiled.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(LifeFixture, life_evolve_all_tiles4) {
+	// a block in one corner stops every tile after the first generation
+	string board = "**......\n**......\n........\n........\n........\n........\n........\n........\n\n";
+	istringstream in(board);
+
+	Life<ConwayCell> l(in, 8, 8);
+	l.set_tile_size(2);
+
+	l.evolve_all();
+	EXPECT_EQ(l.active_tiles.size(), 16u);
+
+	l.evolve_all();
+	EXPECT_EQ(l.active_tiles.size(), 0u);
+	EXPECT_EQ(l.population, 4);
+}
+
 TEST(LifeFixture, life_print1) {
 	istringstream in(".*.\n.*.\n.*.\n\n");
 
@@ -789,6 +1026,39 @@ TEST(LifeFixture, life_print3) {
 
 }
 
+TEST(LifeFixture, life_print4) {
+	istringstream in("-1.\n*-4\n+--\n\n");
+
+	Life<Cell> l(in, 3, 3);
+	l.evolve_all();
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(l.render(), s.str());
+	ASSERT_EQ(l.render(), s.str());
+}
+
+TEST(LifeFixture, life_print5) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	Life<ConwayCell> l(in, 3, 3);
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	l.print(fds[1]);
+	close(fds[1]);
+
+	char buffer[64];
+	const ssize_t n = read(fds[0], buffer, sizeof(buffer));
+	close(fds[0]);
+	ASSERT_EQ(string(buffer, n), "Generation = 0, Population = 3.\n.*.\n.*.\n.*.\n\n");
+}
+
+TEST(LifeFixture, life_print6) {
+	istringstream in("-1-\n2-4\n+--\n\n");
+
+	Life<FredkinCell> l(in, 3, 3);
+	ASSERT_THROW(l.print(-1), runtime_error);
+}
+
 TEST(LifeFixture, life_begin1) {
 
 	istringstream in("...\n.*.\n...\n*..\n\n");
@@ -819,7 +1089,6 @@ TEST(LifeFixture, life_begin2) {
 
 	Life<Cell>::iterator<Cell> c1 = l.begin();
 	ASSERT_EQ((*c1).acell->is_alive(), true); ASSERT_EQ((*c1).acell->is_border(), false);
-	(*c1).~Cell();
 	*c1 = Cell('.');
 	++c1;
 	--c1;
@@ -1039,3 +1308,1573 @@ TEST(LifeFixture, life_const_end3) {
 	--c1;;
 	ASSERT_EQ((*c1).is_alive(), false); ASSERT_EQ((*c1).is_border(), false);
 }
+
+TEST(LifeFixture, life_random_access1) {
+
+	istringstream in("...\n.*.\n...\n*..\n\n");
+
+	Life<ConwayCell> l(in, 4, 3);
+
+	Life<ConwayCell>::iterator<ConwayCell> b = l.begin();
+	Life<ConwayCell>::iterator<ConwayCell> e = l.end();
+	ASSERT_EQ(e - b, 12);
+	ASSERT_EQ(b[4].is_alive(), true);
+	ASSERT_EQ((b + 9)->is_alive(), true);
+	ASSERT_EQ((e - 3)->is_alive(), true);
+	ASSERT_TRUE(b < e);
+	ASSERT_TRUE(b + 12 == e);
+
+	Life<ConwayCell>::iterator<ConwayCell> i = b;
+	for (int n = 0; n < 12; n++)
+		i++;
+	ASSERT_TRUE(i == e);
+	i -= 8;
+	ASSERT_EQ(i - b, 4);
+	ASSERT_EQ(i->is_alive(), true);
+
+	Life<ConwayCell>::const_iterator<ConwayCell> c = i;
+	ASSERT_TRUE(c == i);
+	ASSERT_EQ(std::count_if(l.begin(), l.end(), [] (const ConwayCell& cell) { return cell.is_alive(); }), 2);
+}
+
+TEST(LifeFixture, life_random_access3) {
+
+	istringstream in(".....\n..*..\n..*..\n..*..\n.....\n\n");
+
+	Life<ConwayCell> l(in, 5, 5);
+	const Life<ConwayCell>& c = l;
+
+	// taken before evolving, read after
+	Life<ConwayCell>::iterator<ConwayCell> i = l.begin() + 11;
+	Life<ConwayCell>::const_iterator<ConwayCell> j = c.begin() + 7;
+	Life<ConwayCell>::iterator<ConwayCell> e = l.end();
+	l.evolve_all();
+
+	ASSERT_EQ(i->is_alive(), true);
+	ASSERT_EQ(j->is_alive(), false);
+	ASSERT_EQ(std::count_if(l.begin(), e, [] (const ConwayCell& cell) { return cell.is_alive(); }), 3);
+	ASSERT_EQ(&*i, &l.at(2, 1));
+}
+
+TEST(LifeFixture, life_random_access2) {
+
+	istringstream in("2--\n-3-\n---\n+--\n\n");
+
+	Life<FredkinCell> l(in, 4, 3);
+
+	std::transform(l.begin(), l.end(), l.begin(), [] (const FredkinCell& cell) { return FredkinCell(0, !cell.is_alive()); });
+	ASSERT_EQ(std::count_if(l.begin(), l.end(), [] (const FredkinCell& cell) { return cell.is_alive(); }), 9);
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str().substr(s.str().find('\n') + 1), "-00\n0-0\n000\n-00\n\n");
+}
+
+TEST(LifeFixture, life_row1) {
+
+	istringstream in("...\n.*.\n...\n*..\n\n");
+
+	const Life<ConwayCell> l(in, 4, 3);
+
+	CellSpan<const ConwayCell> r = l.row(1);
+	ASSERT_EQ(r.size(), 3);
+	ASSERT_EQ(r[1].is_alive(), true);
+	ASSERT_EQ(std::count_if(r.begin(), r.end(), [] (const ConwayCell& cell) { return cell.is_alive(); }), 1);
+
+	ASSERT_EQ(l.stride(), 5);
+	ASSERT_EQ(l.data()[3 * l.stride()].is_alive(), true);
+	ASSERT_EQ(&l.data()[1 * l.stride() + 1], &l.at(1, 1));
+}
+
+#if __cplusplus >= 201703L
+TEST(LifeFixture, life_parallel1) {
+
+	istringstream in("...\n.*.\n...\n*..\n\n");
+
+	Life<ConwayCell> l(in, 4, 3);
+
+	ASSERT_EQ(std::count_if(std::execution::par, l.begin(), l.end(), [] (const ConwayCell& cell) { return cell.is_alive(); }), 2);
+}
+#endif
+
+// ------------------
+// ConwayLifeFixture
+// ------------------
+
+TEST(ConwayLifeFixture, conway_life_print1) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	ConwayLife l(in, 3, 3);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 3.\n.*.\n.*.\n.*.\n\n");
+}
+
+TEST(ConwayLifeFixture, conway_life_evolve_all1) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	ConwayLife l(in, 3, 3);
+	l.evolve_all();
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 1, Population = 3.\n...\n***\n...\n\n");
+}
+
+TEST(ConwayLifeFixture, conway_life_evolve_all2) {
+	// a glider crossing the boundary between the first and second word of a row
+	string row(70, '.');
+	string r0 = row, r1 = row, r2 = row;
+	r0[62] = '*';
+	r1[63] = '*';
+	r2[61] = '*'; r2[62] = '*'; r2[63] = '*';
+	istringstream in(r0 + "\n" + r1 + "\n" + r2 + "\n" + row + "\n" + row + "\n\n");
+
+	ConwayLife l(in, 5, 70);
+	for (int i = 0; i < 8; i++)
+		l.evolve_all();
+
+	ASSERT_EQ(l.at(2, 64).is_alive(), true);
+	ASSERT_EQ(l.at(3, 65).is_alive(), true);
+	ASSERT_EQ(l.at(4, 63).is_alive(), true);
+	ASSERT_EQ(l.at(4, 64).is_alive(), true);
+	ASSERT_EQ(l.at(4, 65).is_alive(), true);
+	ASSERT_EQ(l.at(4, 66).is_alive(), false);
+
+	// the glider runs into the bottom border and settles into a block
+	for (int i = 0; i < 8; i++)
+		l.evolve_all();
+
+	ostringstream s;
+	l.print(s);
+	string block = row;
+	block[64] = '*'; block[65] = '*';
+	ASSERT_EQ(s.str(), "Generation = 16, Population = 4.\n" + row + "\n" + row + "\n" + row + "\n" + block + "\n" + block + "\n\n");
+}
+
+TEST(ConwayLifeFixture, conway_life_load1) {
+	istringstream in1("...\n.*.*.*.*\n...\n\n");
+	ASSERT_THROW(ConwayLife(in1, 3, 3), runtime_error);
+
+	istringstream in2("...\n...\n...\n\n");
+	ASSERT_THROW(ConwayLife(in2, 2, 3), runtime_error);
+
+	istringstream in3("...\n\n");
+	ASSERT_THROW(ConwayLife(in3, 2, 3), runtime_error);
+
+	istringstream in4("..\n.0\n\n");
+	ASSERT_THROW(ConwayLife(in4, 2, 2), runtime_error);
+}
+
+TEST(ConwayLifeFixture, conway_life_at1) {
+	istringstream in("...\n.*.\n...\n*..\n\n");
+
+	const ConwayLife l(in, 4, 3);
+
+	ASSERT_EQ(l.at(0, 0).is_alive(), false);
+	ASSERT_EQ(l.at(1, 1).is_alive(), true);
+	ASSERT_EQ(l.at(3, 0).is_alive(), true);
+	ASSERT_EQ(l.at(3, 0).is_border(), false);
+	ASSERT_THROW(l.at(4, 0), out_of_range);
+}
+
+// ------------------
+// FredkinLifeFixture
+// ------------------
+
+TEST(FredkinLifeFixture, fredkin_life_print1) {
+	istringstream in("-1-\n2-4\n+--\n\n");
+
+	FredkinLife l(in, 3, 3);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 4.\n-1-\n2-4\n+--\n\n");
+}
+
+TEST(FredkinLifeFixture, fredkin_life_evolve_all1) {
+	const string text = "-0--9-7\n-+-0--0\n0--0-0-\n--0--8-\n-0-0--1\n\n";
+
+	istringstream in1(text);
+	istringstream in2(text);
+	Life<FredkinCell> l1(in1, 5, 7);
+	FredkinLife l2(in2, 5, 7);
+
+	for (int i = 0; i < 20; i++) {
+		ostringstream s1;
+		ostringstream s2;
+		l1.print(s1);
+		l2.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+
+	for (int x = 0; x < 5; x++)
+		for (int y = 0; y < 7; y++)
+			ASSERT_EQ(l2.at(x, y), l1.at(x, y));
+}
+
+TEST(FredkinLifeFixture, fredkin_life_load1) {
+	istringstream in1("---\n-0-0-0-0\n---\n\n");
+	ASSERT_THROW(FredkinLife(in1, 3, 3), runtime_error);
+
+	istringstream in2("---\n---\n---\n\n");
+	ASSERT_THROW(FredkinLife(in2, 2, 3), runtime_error);
+
+	istringstream in3("---\n\n");
+	ASSERT_THROW(FredkinLife(in3, 2, 3), runtime_error);
+}
+
+TEST(FredkinLifeFixture, fredkin_life_at1) {
+	istringstream in("---\n-+-\n--3\n\n");
+
+	const FredkinLife l(in, 3, 3);
+
+	ASSERT_EQ(l.at(0, 0).is_alive(), false);
+	ASSERT_EQ(l.at(1, 1).age(), 10);
+	ASSERT_EQ(l.at(2, 2).age(), 3);
+	ASSERT_EQ(l.at(2, 2).is_border(), false);
+	ASSERT_THROW(l.at(0, 3), out_of_range);
+}
+
+// ----------------
+// MixedLifeFixture
+// ----------------
+
+TEST(MixedLifeFixture, mixed_life_print1) {
+	istringstream in("-1.\n*-4\n+--\n\n");
+
+	MixedLife l(in, 3, 3);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 4.\n-1.\n*-4\n+--\n\n");
+}
+
+TEST(MixedLifeFixture, mixed_life_evolve_all1) {
+	const string text = "-0.*9-7.\n*+-0..0-\n0-*0-0-*\n-.0--8-.\n-0-0**1-\n.1-.-0*-\n\n";
+
+	istringstream in1(text);
+	istringstream in2(text);
+	Life<Cell> l1(in1, 6, 8);
+	MixedLife l2(in2, 6, 8);
+
+	for (int i = 0; i < 25; i++) {
+		ostringstream s1;
+		ostringstream s2;
+		l1.print(s1);
+		l2.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+
+	for (int x = 0; x < 6; x++)
+		for (int y = 0; y < 8; y++)
+			ASSERT_EQ(l2.at(x, y), l1.at(x, y));
+}
+
+TEST(MixedLifeFixture, mixed_life_evolve_all2) {
+	// the fredkin cell in the middle survives at age 1 and turns into a conway cell
+	istringstream in("---\n-1-\n-0-\n\n");
+
+	MixedLife l(in, 3, 3);
+	l.evolve_all();
+	ASSERT_EQ(l.at(1, 1).symbol(), '*');
+	ASSERT_EQ(CellTraits<Cell>::species(l.at(1, 1)), CONWAY);
+}
+
+TEST(MixedLifeFixture, mixed_life_load1) {
+	istringstream in1("---\n-0-0-0-0\n---\n\n");
+	ASSERT_THROW(MixedLife(in1, 3, 3), runtime_error);
+
+	istringstream in2("---\n---\n---\n\n");
+	ASSERT_THROW(MixedLife(in2, 2, 3), runtime_error);
+
+	istringstream in3("---\n\n");
+	ASSERT_THROW(MixedLife(in3, 2, 3), runtime_error);
+}
+
+TEST(MixedLifeFixture, mixed_life_at1) {
+	istringstream in("-.\n*3\n\n");
+
+	const MixedLife l(in, 2, 2);
+
+	ASSERT_EQ(l.at(0, 0).symbol(), '-');
+	ASSERT_EQ(l.at(0, 1).symbol(), '.');
+	ASSERT_EQ(l.at(1, 0).is_alive(), true);
+	ASSERT_EQ(CellTraits<Cell>::age(l.at(1, 1)), 3);
+	ASSERT_THROW(l.at(2, 0), out_of_range);
+}
+
+// ----------------
+// HashLifeFixture
+// ----------------
+
+TEST(HashLifeFixture, hash_life_print1) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	HashLife l(in, 3, 3);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 3.\n.*.\n.*.\n.*.\n\n");
+}
+
+TEST(HashLifeFixture, hash_life_load1) {
+	istringstream in1("...\n.*.*.*.*\n...\n\n");
+	ASSERT_THROW(HashLife(in1, 3, 3), runtime_error);
+
+	istringstream in2("...\n...\n...\n\n");
+	ASSERT_THROW(HashLife(in2, 2, 3), runtime_error);
+
+	istringstream in3("...\n\n");
+	ASSERT_THROW(HashLife(in3, 2, 3), runtime_error);
+
+	istringstream in4("..\n.0\n\n");
+	ASSERT_THROW(HashLife(in4, 2, 2), runtime_error);
+}
+
+TEST(HashLifeFixture, hash_life_advance1) {
+	// a glider, a blinker and a block far enough from the edge for the border not to matter
+	string board;
+	for (int x = 0; x < 30; x++) {
+		string row(30, '.');
+		if (x == 1) row[2] = '*';
+		if (x == 2) row[3] = '*';
+		if (x == 3) { row[1] = '*'; row[2] = '*'; row[3] = '*'; }
+		if (x == 5 || x == 6) { row[22] = '*'; row[23] = '*'; }
+		if (x == 24) { row[5] = '*'; row[6] = '*'; row[7] = '*'; }
+		board += row + "\n";
+	}
+	board += "\n";
+
+	istringstream in1(board);
+	istringstream in2(board);
+	istringstream in3(board);
+
+	Life<ConwayCell> life(in1, 30, 30);
+	HashLife stepped(in2, 30, 30);
+	HashLife jumped(in3, 30, 30);
+
+	for (int i = 1; i <= 40; i++) {
+		life.evolve_all();
+		stepped.advance(1);
+
+		ostringstream s1, s2;
+		life.print(s1);
+		stepped.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+	}
+
+	jumped.jump_to(40);
+
+	ostringstream s1, s2;
+	stepped.print(s1);
+	jumped.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(HashLifeFixture, hash_life_advance2) {
+	istringstream in(".....\n..*..\n..*..\n..*..\n.....\n\n");
+
+	HashLife l(in, 5, 5);
+	l.advance(1000000001ULL);
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 1000000001, Population = 3.\n.....\n.....\n.***.\n.....\n.....\n\n");
+}
+
+TEST(HashLifeFixture, hash_life_advance3) {
+	// a glider moves one cell down and right every 4 generations
+	istringstream in(".*.\n..*\n***\n\n");
+
+	HashLife l(in, 3, 3);
+	l.set_cache_limit(1000);
+	l.jump_to(4000000000ULL);
+
+	const long long d = 1000000000LL;
+	ASSERT_EQ(l.at(d, d + 1).is_alive(), true);
+	ASSERT_EQ(l.at(d + 1, d + 2).is_alive(), true);
+	ASSERT_EQ(l.at(d + 2, d).is_alive(), true);
+	ASSERT_EQ(l.at(d + 2, d + 1).is_alive(), true);
+	ASSERT_EQ(l.at(d + 2, d + 2).is_alive(), true);
+	ASSERT_EQ(l.at(d + 1, d + 1).is_alive(), false);
+	ASSERT_EQ(l.at(0, 1).is_alive(), false);
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 4000000000, Population = 5.\n...\n...\n...\n\n");
+}
+
+TEST(HashLifeFixture, hash_life_advance4) {
+	istringstream in(".....\n..*..\n..*..\n..*..\n.....\n\n");
+
+	HashLife l(in, 5, 5);
+	l.jump_to(10);
+	ASSERT_THROW(l.jump_to(9), invalid_argument);
+	ASSERT_THROW(l.advance(1ULL << 61), overflow_error);
+
+	// the furthest a single call reaches, every step up to 2^60
+	l.advance((1ULL << 61) - 1);
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 2305843009213693961, Population = 3.\n.....\n.....\n.***.\n.....\n.....\n\n");
+}
+
+// -----------------
+// SparseLifeFixture
+// -----------------
+
+TEST(SparseLifeFixture, sparse_life_print1) {
+	istringstream in("-1-\n2-4\n+--\n\n");
+
+	SparseLife<FredkinCell> l(in, 3, 3);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 4.\n-1-\n2-4\n+--\n\n");
+}
+
+TEST(SparseLifeFixture, sparse_life_evolve_all1) {
+	// away from the border the sparse plane and the bounded board agree
+	string board;
+	for (int x = 0; x < 40; x++) {
+		string row(40, '.');
+		if (x == 14) row[15] = '*';
+		if (x == 15) row[16] = '*';
+		if (x == 16) { row[14] = '*'; row[15] = '*'; row[16] = '*'; }
+		if (x == 20) { row[30] = '*'; row[31] = '*'; row[32] = '*'; }
+		board += row + "\n";
+	}
+	board += "\n";
+
+	istringstream in1(board);
+	istringstream in2(board);
+
+	Life<ConwayCell> life(in1, 40, 40);
+	SparseLife<ConwayCell> sparse(in2, 40, 40);
+
+	for (int i = 0; i < 30; i++) {
+		life.evolve_all();
+		sparse.evolve_all();
+
+		ostringstream s1, s2;
+		life.print(s1);
+		sparse.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+	}
+}
+
+TEST(SparseLifeFixture, sparse_life_evolve_all2) {
+	// a glider leaves the board it was read from and keeps going
+	istringstream in(".*.\n..*\n***\n\n");
+
+	SparseLife<ConwayCell> l(in, 3, 3);
+	for (int i = 0; i < 400; i++)
+		l.evolve_all();
+
+	ASSERT_EQ(l.at(100, 101).is_alive(), true);
+	ASSERT_EQ(l.at(101, 102).is_alive(), true);
+	ASSERT_EQ(l.at(102, 100).is_alive(), true);
+	ASSERT_EQ(l.at(102, 101).is_alive(), true);
+	ASSERT_EQ(l.at(102, 102).is_alive(), true);
+	ASSERT_EQ(l.at(-5, -5).is_alive(), false);
+	ASSERT_LE(l.chunk_count(), 4u);
+
+	ostringstream s;
+	l.print(s, 100, 100, 3, 3);
+	ASSERT_EQ(s.str(), "Generation = 400, Population = 5.\n.*.\n..*\n***\n\n");
+}
+
+TEST(SparseLifeFixture, sparse_life_evolve_all3) {
+	// a glider flying up and left crosses into negative coordinates
+	istringstream in("***\n*..\n.*.\n\n");
+
+	SparseLife<ConwayCell> l(in, 3, 3);
+	for (int i = 0; i < 80; i++)
+		l.evolve_all();
+
+	ostringstream s;
+	l.print(s, -20, -20, 3, 3);
+	ASSERT_EQ(s.str(), "Generation = 80, Population = 5.\n***\n*..\n.*.\n\n");
+}
+
+TEST(SparseLifeFixture, sparse_life_evolve_all4) {
+	// empty space around a mixed board is dead Conway cells
+	string board = ".*-5..\n*.+-*.\n-.19-*\n.-*-..\n0-.*1-\n\n";
+	string padded = "........\n..*-5...\n.*.+-*..\n.-.19-*.\n..-*-...\n.0-.*1-.\n........\n\n";
+	istringstream in1(board);
+	istringstream in2(padded);
+
+	SparseLife<Cell> sparse(in1, 5, 6);
+	Life<Cell> life(in2, 7, 8);
+
+	sparse.evolve_all();
+	life.evolve_all();
+
+	ostringstream s1, s2;
+	sparse.print(s1, -1, -1, 7, 8);
+	life.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(SparseLifeFixture, sparse_life_chunks1) {
+	// a blinker dies out, its chunk is freed
+	istringstream in("**.\n...\n...\n\n");
+
+	SparseLife<ConwayCell> l(in, 3, 3);
+	ASSERT_EQ(l.chunk_count(), 1u);
+
+	l.evolve_all();
+	ASSERT_EQ(l.chunk_count(), 0u);
+	ASSERT_EQ(l.at(0, 0).is_alive(), false);
+}
+
+TEST(SparseLifeFixture, sparse_life_chunks2) {
+	// a block at the origin, and nothing 2^36 cells away either way
+	istringstream in("**\n**\n\n");
+
+	SparseLife<ConwayCell> l(in, 2, 2);
+	for (int i = 0; i < 3; i++)
+		l.evolve_all();
+
+	const long long far = 1LL << 36;
+	ASSERT_EQ(l.at(0, 0).is_alive(), true);
+	ASSERT_EQ(l.at(far, 0).is_alive(), false);
+	ASSERT_EQ(l.at(-far, 0).is_alive(), false);
+	ASSERT_EQ(l.at(0, far).is_alive(), false);
+	ASSERT_EQ(l.at(far, far).is_alive(), false);
+	ASSERT_EQ(l.chunk_count(), 1u);
+
+	ostringstream s;
+	l.print(s, far, far, 2, 2);
+	ASSERT_EQ(s.str(), "Generation = 3, Population = 4.\n..\n..\n\n");
+}
+
+// ----------------
+// LifeLoadFixture
+// ----------------
+
+TEST(LifeLoadFixture, life_load_stream1) {
+	istringstream in("-1-\n2-4\n+--\n\n.*.\n.*.\n\n");
+
+	Life<FredkinCell> l1(in);
+	Life<ConwayCell> l2(in);
+
+	ostringstream s1, s2;
+	l1.print(s1);
+	l2.print(s2);
+	ASSERT_EQ(s1.str(), "Generation = 0, Population = 4.\n-1-\n2-4\n+--\n\n");
+	ASSERT_EQ(s2.str(), "Generation = 0, Population = 2.\n.*.\n.*.\n\n");
+}
+
+TEST(LifeLoadFixture, life_load_memory1) {
+	const string text = ".*-5\n*.+-\n-.19\n\n....\n";
+
+	Life<Cell> l(text.data(), text.data() + text.size());
+	l.evolve_all();
+
+	istringstream in(".*-5\n*.+-\n-.19\n\n");
+	Life<Cell> l2(in, 3, 4);
+	l2.evolve_all();
+
+	ostringstream s1, s2;
+	l.print(s1);
+	l2.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+}
+
+TEST(LifeLoadFixture, life_load_memory2) {
+	// no newline after the last row
+	const string text = ".*.\n.*.\n.*.";
+
+	Life<ConwayCell> l(text.data(), text.data() + text.size());
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 3.\n.*.\n.*.\n.*.\n\n");
+}
+
+TEST(LifeLoadFixture, life_load_ragged1) {
+	const string text = "...\n.*.*.*.*\n...\n\n";
+	ASSERT_THROW(Life<ConwayCell>(text.data(), text.data() + text.size()), runtime_error);
+
+	istringstream in1(text);
+	ASSERT_THROW(Life<ConwayCell>(in1, 3, 3), runtime_error);
+
+	istringstream in2("...\n...\n...\n\n");
+	ASSERT_THROW(Life<ConwayCell>(in2, 2, 3), runtime_error);
+
+	istringstream in3("...\n\n");
+	ASSERT_THROW(Life<ConwayCell>(in3, 2, 3), runtime_error);
+}
+
+TEST(LifeLoadFixture, life_load_file1) {
+	char path[] = "/tmp/TestLife.XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	{
+		ofstream out(path);
+		out << "...\n.*.\n...\n*..\n\n";
+	}
+
+	Life<ConwayCell> l((string(path)));
+	remove(path);
+
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 2.\n...\n.*.\n...\n*..\n\n");
+}
+
+TEST(LifeLoadFixture, life_load_file2) {
+	ASSERT_THROW(Life<ConwayCell>(string("/nonexistent/board")), runtime_error);
+}
+
+TEST(LifeSnapshotFixture, life_snapshot1) {
+	istringstream in(".....\n..*..\n..*..\n..*..\n.....\n\n");
+
+	Life<ConwayCell> l(in, 5, 5);
+	l.evolve_all();
+	const string bytes = l.snapshot();
+	ASSERT_EQ(bytes.size(), sizeof(SnapshotHeader) + 8);
+
+	Life<ConwayCell> r(bytes.data(), bytes.data() + bytes.size());
+	ostringstream s1;
+	ostringstream s2;
+	l.print(s1);
+	r.print(s2);
+	ASSERT_EQ(s1.str(), s2.str());
+
+	l.evolve_all();
+	r.evolve_all();
+	ASSERT_EQ(l.render(), r.render());
+}
+
+TEST(LifeSnapshotFixture, life_snapshot2) {
+	istringstream in("-----\n-+-0-\n--9--\n-0---\n-----\n\n");
+
+	Life<FredkinCell> l(in, 5, 5);
+	ASSERT_EQ(l.at(1, 1).age(), 10);
+
+	const string bytes = l.snapshot();
+	Life<FredkinCell> r(bytes.data(), bytes.data() + bytes.size());
+	for (int x = 0; x < 5; x++)
+		for (int y = 0; y < 5; y++)
+			ASSERT_EQ(r.at(x, y), l.at(x, y));
+
+	for (int i = 0; i < 5; i++) {
+		l.evolve_all();
+		r.evolve_all();
+	}
+	ASSERT_EQ(l.render(), r.render());
+}
+
+TEST(LifeSnapshotFixture, life_snapshot3) {
+	istringstream in("-*.0\n.1-*\n*.-+\n\n");
+
+	Life<Cell> l(in, 3, 4);
+	l.evolve_all();
+	l.evolve_all();
+
+	char path[] = "/tmp/TestLife.XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	l.save(string(path));
+	Life<Cell> r((string(path)));
+	remove(path);
+
+	for (int x = 0; x < 3; x++)
+		for (int y = 0; y < 4; y++)
+			ASSERT_EQ(r.at(x, y), l.at(x, y));
+
+	for (int i = 0; i < 4; i++) {
+		l.evolve_all();
+		r.evolve_all();
+	}
+	ASSERT_EQ(l.render(), r.render());
+}
+
+TEST(LifeSnapshotFixture, life_snapshot4) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	Life<ConwayCell> l(in, 3, 3);
+	ostringstream out;
+	l.save(out);
+	const string bytes = out.str();
+
+	ASSERT_THROW(Life<FredkinCell>(bytes.data(), bytes.data() + bytes.size()), runtime_error);
+	ASSERT_THROW(Life<ConwayCell>(bytes.data(), bytes.data() + bytes.size() - 1), runtime_error);
+}
+
+TEST(LifeSnapshotFixture, life_snapshot5) {
+	istringstream in("-0\n0-\n\n");
+
+	Life<FredkinCell> l(in, 2, 2);
+	string bytes = l.snapshot();
+
+	// 2101286760 * 2128190232 cells of bits and ages need 27744 bytes once the size wraps around 2^64
+	const uint32_t h = 2101286760u;
+	const uint32_t w = 2128190232u;
+	memcpy(&bytes[16], &h, 4);
+	memcpy(&bytes[20], &w, 4);
+	bytes.resize(27744);
+
+	ASSERT_THROW(Life<FredkinCell>(bytes.data(), bytes.data() + bytes.size()), runtime_error);
+}
+
+TEST(LifeSnapshotFixture, life_snapshot6) {
+	char directory[] = "/tmp/TestLife.XXXXXX";
+	ASSERT_NE(mkdtemp(directory), nullptr);
+	const string path = string(directory) + "/board";
+
+	// every thread writes whole files of its own, of its own size
+	vector<thread> writers;
+	for (int t = 0; t < 4; t++)
+		writers.push_back(thread([t, &path] () {
+			for (int i = 0; i < 50; i++)
+				write_file(path, string(1000 * (t + 1), static_cast<char>('a' + t)));
+		}));
+	for (thread& w : writers)
+		w.join();
+
+	ifstream in(path);
+	const string written((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	ASSERT_FALSE(written.empty());
+	ASSERT_EQ(written, string(written.size(), written[0]));
+	ASSERT_EQ(written.size(), 1000u * (written[0] - 'a' + 1));
+
+	// and no temporary file is left behind
+	DIR* d = opendir(directory);
+	ASSERT_NE(d, nullptr);
+	int files = 0;
+	while (dirent* e = readdir(d))
+		if (e->d_name[0] != '.')
+			files++;
+	closedir(d);
+	ASSERT_EQ(files, 1);
+
+	remove(path.c_str());
+	rmdir(directory);
+}
+
+#ifdef LIFE_STATS
+TEST(LifeStatsFixture, life_stats1) {
+	istringstream in(".....\n..*..\n..*..\n..*..\n.....\n\n");
+
+	Life<ConwayCell> l(in, 5, 5);
+	ASSERT_EQ(l.stats().generation, 0);
+
+	l.evolve_all();
+	const LifeStats& s = l.stats();
+	ASSERT_EQ(s.generation, 1);
+	ASSERT_EQ(s.evaluated, 25);
+	ASSERT_EQ(s.changed, 4);
+	ASSERT_EQ(s.births, 2);
+	ASSERT_EQ(s.deaths, 2);
+	ASSERT_EQ(s.ages[0], 0);
+	ASSERT_GE(s.seconds, 0.0);
+}
+
+TEST(LifeStatsFixture, life_stats2) {
+	istringstream in("-----\n-0-0-\n--9--\n-0-+-\n-----\n\n");
+
+	Life<FredkinCell> l(in, 5, 5);
+	vector<LifeStats> seen;
+	l.set_stats_callback([&seen](const LifeStats& s) { seen.push_back(s); });
+
+	l.evolve_all();
+	l.evolve_all();
+	ASSERT_EQ(seen.size(), 2u);
+	ASSERT_EQ(seen[1].generation, 2);
+
+	long long live = 0;
+	for (int a = 0; a < 11; a++)
+		live += seen[1].ages[a];
+	ostringstream out;
+	l.print(out);
+	ASSERT_EQ(out.str().find("Population = " + to_string(live) + "."), 16u);
+	ASSERT_EQ(seen[1].clones, 0u);
+}
+
+TEST(LifeStatsFixture, life_stats3) {
+	istringstream in("-*.0\n.1-*\n*.-+\n\n");
+
+	Life<Cell> l(in, 3, 4);
+	l.evolve_all();
+	ASSERT_GE(l.stats().clones, 12u);
+	ASSERT_EQ(l.stats().ages[10], 1);
+}
+
+TEST(LifeStatsFixture, life_stats_threads1) {
+	const string text = "-0.*9-7.\n*+-0..0-\n0-*0-0-*\n-.0--8-.\n-0-0**1-\n.1-.-0*-\n\n";
+
+	istringstream in1(text);
+	Life<Cell> l1(in1, 6, 8);
+	l1.evolve_all();
+
+	// the clones of every band are added up, none counted twice
+	istringstream in2(text);
+	Life<Cell> l2(in2, 6, 8);
+	l2.set_threads(3);
+	l2.evolve_all();
+	ASSERT_EQ(l2.stats().clones, l1.stats().clones);
+	ASSERT_EQ(l2.stats().allocations, l1.stats().allocations);
+
+	// a board that clones nothing counts nothing while another one does
+	istringstream in3("-----\n-0-0-\n--9--\n-0-+-\n-----\n\n");
+	Life<FredkinCell> l3(in3, 5, 5);
+	thread busy([&l1] {
+		for (int i = 0; i < 200; i++)
+			l1.evolve_all();
+	});
+	unsigned long long clones = 0;
+	for (int i = 0; i < 200; i++) {
+		l3.evolve_all();
+		clones += l3.stats().clones;
+	}
+	busy.join();
+	ASSERT_EQ(clones, 0u);
+}
+
+TEST(LifeStatsFixture, life_stats4) {
+	string text(64 * 65 + 1, '.');
+	for (int x = 0; x < 64; x++)
+		text[x * 65 + 64] = '\n';
+	text[64 * 65] = '\n';
+	text[1 * 65 + 1] = text[1 * 65 + 2] = text[2 * 65 + 1] = text[2 * 65 + 2] = '*';
+
+	Life<ConwayCell> l(text.data(), text.data() + text.size());
+	l.set_tile_size(16);
+	l.evolve_all();
+	ASSERT_EQ(l.stats().evaluated, 64 * 64);
+	ASSERT_EQ(l.stats().changed, 0);
+	l.evolve_all();
+	ASSERT_EQ(l.stats().evaluated, 0);
+
+	l.at(40, 40) = ConwayCell('*');
+	l.set_tile_size(16);
+	l.evolve_all();
+	l.evolve_all();
+	ASSERT_EQ(l.stats().evaluated, 9 * 16 * 16);
+	ASSERT_EQ(l.stats().deaths, 0);
+}
+#endif
+
+TEST(RuleCellFixture, rule_cell1) {
+	ASSERT_FALSE(is_polymorphic<ConwayRuleCell>::value);
+	ASSERT_TRUE(ConwayRule::next(false, 3));
+	ASSERT_TRUE(ConwayRule::next(true, 2));
+	ASSERT_FALSE(ConwayRule::next(true, 4));
+	ASSERT_FALSE(ConwayRule::next(false, 6));
+	ASSERT_TRUE(HighLifeRule::next(false, 6));
+	ASSERT_FALSE(SeedsRule::next(true, 2));
+	ASSERT_EQ(FredkinRule::neighbors, 4);
+}
+
+TEST(RuleCellFixture, rule_cell2) {
+	const string text = "..*...*.\n*..**...\n.*.*..**\n**...*..\n..**.*.*\n*....**.\n.**.*...\n...*..**\n\n";
+
+	Life<ConwayCell> l1(text.data(), text.data() + text.size());
+	Life<ConwayRuleCell> l2(text.data(), text.data() + text.size());
+	for (int i = 0; i < 10; i++) {
+		ASSERT_EQ(l1.render(), l2.render());
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+}
+
+TEST(RuleCellFixture, rule_cell3) {
+	const string text = "-0--9-\n-+-0--\n0--0-0\n--0--8\n-0-0--\n\n";
+
+	Life<FredkinCell> l1(text.data(), text.data() + text.size());
+	Life<FredkinRuleCell> l2(text.data(), text.data() + text.size());
+	for (int i = 0; i < 12; i++) {
+		ASSERT_EQ(l1.render(), l2.render());
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+	ASSERT_EQ(l1.at(0, 4).age(), l2.at(0, 4).age());
+}
+
+TEST(RuleCellFixture, rule_cell4) {
+	const string text = "**.\n*.*\n.**\n\n";
+
+	Life<ConwayRuleCell> l1(text.data(), text.data() + text.size());
+	Life<HighLifeCell> l2(text.data(), text.data() + text.size());
+	l1.evolve_all();
+	l2.evolve_all();
+	ASSERT_FALSE(l1.at(1, 1).is_alive());
+	ASSERT_TRUE(l2.at(1, 1).is_alive());
+}
+
+TEST(RuleCellFixture, rule_cell5) {
+	const string text = "....\n.**.\n....\n\n";
+
+	Life<SeedsCell> l(text.data(), text.data() + text.size());
+	l.evolve_all();
+	ASSERT_EQ(l.render(), "Generation = 1, Population = 4.\n.**.\n....\n.**.\n\n");
+}
+
+TEST(RuleCellFixture, rule_cell6) {
+	const string text = "**.\n*.*\n.**\n\n";
+
+	Life<HighLifeCell> l(text.data(), text.data() + text.size());
+	l.evolve_all();
+	const string bytes = l.snapshot();
+
+	Life<HighLifeCell> r(bytes.data(), bytes.data() + bytes.size());
+	ASSERT_EQ(r.render(), l.render());
+	ASSERT_THROW(Life<ConwayRuleCell>(bytes.data(), bytes.data() + bytes.size()), runtime_error);
+}
+
+TEST(LifeCycleFixture, life_cycle1) {
+	const string text = ".....\n..*..\n..*..\n..*..\n.....\n\n";
+
+	Life<ConwayCell> l1(text.data(), text.data() + text.size());
+	Life<ConwayCell> l2(text.data(), text.data() + text.size());
+	l2.set_cycle_detection(8);
+	for (int i = 0; i < 1001; i++)
+		l1.evolve_all();
+	l2.jump_to(1001);
+
+	ASSERT_EQ(l2.period(), 2);
+	ASSERT_EQ(l2.render(), l1.render());
+}
+
+TEST(LifeCycleFixture, life_cycle2) {
+	const string text = "....\n.**.\n.**.\n....\n\n";
+
+	Life<ConwayCell> l(text.data(), text.data() + text.size());
+	l.set_cycle_detection(1);
+	l.jump_to(3);
+	ASSERT_EQ(l.period(), 1);
+	l.jump_to(1000000);
+	ASSERT_EQ(l.render(), "Generation = 1000000, Population = 4.\n....\n.**.\n.**.\n....\n\n");
+}
+
+TEST(LifeCycleFixture, life_cycle3) {
+	// a glider never repeats on the board, its hashes never match
+	const string text = ".*......\n..*.....\n***.....\n........\n........\n........\n........\n........\n\n";
+
+	Life<ConwayCell> l1(text.data(), text.data() + text.size());
+	Life<ConwayCell> l2(text.data(), text.data() + text.size());
+	l2.set_cycle_detection(4);
+	for (int i = 0; i < 12; i++)
+		l1.evolve_all();
+	l2.jump_to(12);
+
+	ASSERT_EQ(l2.period(), 0);
+	ASSERT_EQ(l2.render(), l1.render());
+}
+
+TEST(LifeCycleFixture, life_cycle4) {
+	// fredkin cells keep aging, so the board looks the same but is not
+	const string text = "-----\n-----\n-0-0-\n-----\n-----\n\n";
+
+	Life<FredkinCell> l1(text.data(), text.data() + text.size());
+	Life<FredkinCell> l2(text.data(), text.data() + text.size());
+	l2.set_cycle_detection(16);
+	for (int i = 0; i < 40; i++)
+		l1.evolve_all();
+	l2.jump_to(40);
+
+	ASSERT_EQ(l2.render(), l1.render());
+	for (int x = 0; x < 5; x++)
+		for (int y = 0; y < 5; y++)
+			ASSERT_EQ(l2.at(x, y), l1.at(x, y));
+}
+
+TEST(WorkStealingPoolFixture, work_stealing_pool1) {
+	WorkStealingPool pool(4);
+	ASSERT_EQ(pool.size(), 4);
+
+	// uneven tasks, all on the first thread's share, must still all run once
+	vector<int> runs(100, 0);
+	pool.run(100, [&runs](int i) {
+		if (i < 25)
+			this_thread::sleep_for(chrono::microseconds(200));
+		runs[i]++;
+	});
+	ASSERT_EQ(runs, vector<int>(100, 1));
+
+	pool.run(0, [](int) {});
+}
+
+TEST(WorkStealingPoolFixture, work_stealing_pool2) {
+	WorkStealingPool pool(3);
+	ASSERT_THROW(pool.run(10, [](int i) {
+		if (i == 7)
+			throw runtime_error("task");
+	}), runtime_error);
+}
+
+TEST(BatchFixture, batch1) {
+	const string conway = ".....\n..*..\n..*..\n..*..\n.....\n";
+	const string fredkin = "-0--\n-+-0\n0--0\n";
+	const string mixed = "-*.0\n.1-*\n*.-+\n";
+
+	vector<LifeJob> jobs;
+	for (int i = 0; i < 30; i++) {
+		vector<int> prints;
+		for (int g = 0; g <= i % 7; g += 2)
+			prints.push_back(g);
+		const CellKind kind = static_cast<CellKind>(i % 3);
+		const string& board = (kind == CONWAY_CELLS) ? conway : (kind == FREDKIN_CELLS ? fredkin : mixed);
+		jobs.push_back(LifeJob(kind, board, i % 7, prints, "job " + to_string(i) + "\n"));
+	}
+
+	string sequential;
+	for (const LifeJob& job : jobs)
+		sequential += run_job(job);
+
+	ostringstream out;
+	run_batch(jobs, 4, out);
+	ASSERT_EQ(out.str(), sequential);
+}
+
+TEST(BatchFixture, batch2) {
+	LifeJob job(CONWAY_CELLS, ".....\n..*..\n..*..\n..*..\n.....\n", 1001);
+	job.cycle_history = 4;
+	ASSERT_EQ(run_job(job), "Generation = 1001, Population = 3.\n.....\n.....\n.***.\n.....\n.....\n\n");
+}
+
+TEST(LifeEvolveNFixture, life_evolve_n1) {
+	const string text = "..*...*.\n*..**...\n.*.*..**\n**...*..\n..**.*.*\n*....**.\n.**.*...\n...*..**\n\n";
+
+	Life<Cell> l1(text.data(), text.data() + text.size());
+	ostringstream s1;
+	for (int i = 0; i <= 30; i++) {
+		if (i % 4 == 0 || i == 13)
+			l1.print(s1);
+		if (i < 30)
+			l1.evolve_all();
+	}
+
+	Life<Cell> l2(text.data(), text.data() + text.size());
+	vector<int> schedule;
+	for (int i = 0; i <= 30; i++)
+		if (i % 4 == 0 || i == 13)
+			schedule.push_back(i);
+	ostringstream s2;
+	l2.evolve_n(30, schedule, s2, 1);
+
+	ASSERT_EQ(s2.str(), s1.str());
+	ASSERT_EQ(l2.render(), l1.render());
+}
+
+TEST(LifeEvolveNFixture, life_evolve_n2) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	Life<ConwayCell> l(in, 3, 3);
+	ostringstream s;
+	l.evolve_n(5, vector<int>(), s);
+	ASSERT_EQ(s.str(), "");
+
+	l.evolve_n(2, vector<int>(1, 7), s);
+	ASSERT_EQ(s.str(), "Generation = 7, Population = 3.\n...\n***\n...\n\n");
+}
+
+TEST(LifeEvolveNFixture, life_evolve_n4) {
+	istringstream in(".*.\n.*.\n.*.\n\n");
+
+	Life<ConwayCell> l(in, 3, 3);
+	l.jump_to(4);
+	ASSERT_THROW(l.jump_to(3), invalid_argument);
+
+	ostringstream s;
+	ASSERT_THROW(l.evolve_n(-1, vector<int>(), s), invalid_argument);
+	ASSERT_THROW(l.evolve_n(5, vector<int>(1, 3), s), invalid_argument);
+	ASSERT_THROW(l.evolve_n(5, vector<int>(1, 10), s), invalid_argument);
+
+	const int backwards[] = {6, 5};
+	ASSERT_THROW(l.evolve_n(5, vector<int>(backwards, backwards + 2), s), invalid_argument);
+
+	// nothing evolved and nothing written
+	ASSERT_EQ(s.str(), "");
+	ASSERT_EQ(l.render(), "Generation = 4, Population = 3.\n.*.\n.*.\n.*.\n\n");
+}
+
+TEST(LifeEvolveNFixture, life_evolve_n3) {
+	ostringstream s;
+	{
+		FrameWriter writer(s, 2);
+		for (int i = 0; i < 100; i++) {
+			string frame = to_string(i) + ",";
+			writer.push(frame);
+		}
+	}
+
+	string expected;
+	for (int i = 0; i < 100; i++)
+		expected += to_string(i) + ",";
+	ASSERT_EQ(s.str(), expected);
+}
+
+TEST(TiledLifeFixture, tiled_life_print1) {
+	istringstream in("-1.\n*-4\n+--\n\n");
+
+	TiledLife<Cell> l(in, 3, 3, 2);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 4.\n-1.\n*-4\n+--\n\n");
+}
+
+TEST(TiledLifeFixture, tiled_life_evolve_all1) {
+	// a soup whose sides are not a multiple of the tile
+	string text;
+	for (int x = 0; x < 37; x++) {
+		for (int y = 0; y < 53; y++)
+			text += ((x * 7 + y * 13 + x * y) % 5 < 2) ? '*' : '.';
+		text += '\n';
+	}
+	text += '\n';
+
+	istringstream in1(text);
+	istringstream in2(text);
+	Life<ConwayCell> l1(in1, 37, 53);
+	TiledLife<ConwayCell> l2(in2, 37, 53, 16);
+
+	for (int i = 0; i < 30; i++) {
+		ostringstream s1;
+		ostringstream s2;
+		l1.print(s1);
+		l2.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+}
+
+TEST(TiledLifeFixture, tiled_life_evolve_all2) {
+	const string text = "-0.*9-7.\n*+-0..0-\n0-*0-0-*\n-.0--8-.\n-0-0**1-\n.1-.-0*-\n\n";
+
+	istringstream in1(text);
+	istringstream in2(text);
+	Life<Cell> l1(in1, 6, 8);
+	TiledLife<Cell> l2(in2, 6, 8, 3);
+
+	for (int i = 0; i < 12; i++) {
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+
+	for (int x = 0; x < 6; x++)
+		for (int y = 0; y < 8; y++)
+			ASSERT_EQ(l2.at(x, y), l1.at(x, y));
+}
+
+TEST(TiledLifeFixture, tiled_life_load1) {
+	istringstream in1("...\n.*.*.*.*\n...\n\n");
+	ASSERT_THROW(TiledLife<ConwayCell>(in1, 3, 3, 2), runtime_error);
+
+	istringstream in2("...\n...\n...\n\n");
+	ASSERT_THROW(TiledLife<ConwayCell>(in2, 2, 3, 2), runtime_error);
+
+	istringstream in3("...\n\n");
+	ASSERT_THROW(TiledLife<ConwayCell>(in3, 2, 3, 2), runtime_error);
+}
+
+TEST(TiledLifeFixture, tiled_life_iterator1) {
+	istringstream in("...\n.*.\n...\n*..\n\n");
+
+	TiledLife<ConwayCell> l(in, 4, 3, 2);
+	int live = 0;
+	int cells = 0;
+	for (TiledLife<ConwayCell>::iterator i = l.begin(); i != l.end(); ++i) {
+		cells++;
+		if ((*i).is_alive())
+			live++;
+	}
+	ASSERT_EQ(cells, 12);
+	ASSERT_EQ(live, 2);
+
+	const TiledLife<ConwayCell>& c = l;
+	TiledLife<ConwayCell>::const_iterator e = c.end();
+	--e;
+	ASSERT_EQ((*e).is_alive(), false);
+	--e; --e;
+	ASSERT_EQ((*e).is_alive(), true);
+
+	l.at(0, 0) = ConwayCell('*');
+	ASSERT_EQ((*l.begin()).is_alive(), true);
+	ASSERT_THROW(l.at(4, 0), out_of_range);
+}
+
+TEST(TiledLifeFixture, tiled_life_iterator2) {
+	string text;
+	for (int x = 0; x < 11; x++) {
+		for (int y = 0; y < 13; y++)
+			text += ((x * 5 + y * 3 + x * y) % 7 < 3) ? '*' : '.';
+		text += '\n';
+	}
+	text += '\n';
+
+	istringstream in1(text);
+	Life<ConwayCell> l1(in1, 11, 13);
+	istringstream in2(text);
+	TiledLife<ConwayCell> l2(in2, 11, 13, 4);
+
+	// taken before evolving, read after
+	TiledLife<ConwayCell>::iterator b = l2.begin();
+	l1.evolve_all();
+	l2.evolve_all();
+
+	ASSERT_TRUE(std::equal(b, l2.end(), l1.begin(), [] (const ConwayCell& c1, const ConwayCell& c2) { return c1.is_alive() == c2.is_alive(); }));
+	ASSERT_EQ(std::count_if(l2.begin(), l2.end(), [] (const ConwayCell& c) { return c.is_alive(); }),
+		std::count_if(l1.begin(), l1.end(), [] (const ConwayCell& c) { return c.is_alive(); }));
+	ASSERT_EQ(std::distance(l2.begin(), l2.end()), 11 * 13);
+
+	// backwards over every row and tile edge
+	const TiledLife<ConwayCell>& c = l2;
+	TiledLife<ConwayCell>::const_iterator i = c.end();
+	for (int x = 10; x >= 0; x--)
+		for (int y = 12; y >= 0; y--) {
+			--i;
+			ASSERT_EQ(&*i, &l2.at(x, y));
+		}
+	ASSERT_TRUE(i == c.begin());
+}
+
+TEST(DistributedLifeFixture, distributed_life_print1) {
+	istringstream in("-1.\n*-4\n+--\n\n");
+
+	DistributedLife<Cell> l(in, 3, 3, 2);
+	ostringstream s;
+	l.print(s);
+	ASSERT_EQ(s.str(), "Generation = 0, Population = 4.\n-1.\n*-4\n+--\n\n");
+}
+
+TEST(DistributedLifeFixture, distributed_life_evolve_n1) {
+	string text;
+	for (int x = 0; x < 29; x++) {
+		for (int y = 0; y < 31; y++)
+			text += ((x * 7 + y * 13 + x * y) % 5 < 2) ? '*' : '.';
+		text += '\n';
+	}
+	text += '\n';
+
+	istringstream in1(text);
+	istringstream in2(text);
+	Life<ConwayCell> l1(in1, 29, 31);
+	DistributedLife<ConwayCell> l2(in2, 29, 31, 4);
+
+	for (int i = 0; i < 10; i++) {
+		ostringstream s1;
+		ostringstream s2;
+		l1.print(s1);
+		l2.print(s2);
+		ASSERT_EQ(s1.str(), s2.str());
+
+		for (int j = 0; j < 3; j++)
+			l1.evolve_all();
+		l2.evolve_n(3);
+	}
+	ASSERT_EQ(l2.get_generation(), 30);
+}
+
+TEST(DistributedLifeFixture, distributed_life_at1) {
+	const string text = "-0.*9-7.\n*+-0..0-\n0-*0-0-*\n-.0--8-.\n-0-0**1-\n.1-.-0*-\n\n";
+
+	istringstream in1(text);
+	istringstream in2(text);
+	Life<Cell> l1(in1, 6, 8);
+	DistributedLife<Cell> l2(in2, 6, 8, 3);
+
+	for (int i = 0; i < 12; i++) {
+		l1.evolve_all();
+		l2.evolve_all();
+	}
+
+	for (int x = 0; x < 6; x++)
+		for (int y = 0; y < 8; y++)
+			ASSERT_EQ(l2.at(x, y), l1.at(x, y));
+	ASSERT_THROW(l2.at(6, 0), out_of_range);
+}
+
+TEST(DistributedLifeFixture, distributed_life_failure1) {
+	istringstream in("...\n***\n...\n...\n\n");
+
+	DistributedLife<ConwayCell> l(in, 4, 3, 2);
+	l.evolve_all();
+	ASSERT_EQ(l.get_population(), 3);
+
+	kill(l.worker(1), SIGKILL);
+	ASSERT_THROW(l.evolve_all(), runtime_error);
+	ASSERT_THROW(l.evolve_all(), runtime_error);
+}
+
+TEST(DeltaFixture, print_delta1) {
+	istringstream in(".....\n.....\n.***.\n.....\n\n");
+	Life<ConwayCell> l(in, 4, 5);
+
+	ostringstream s;
+	l.print_delta(s);
+	l.evolve_all();
+	l.print_delta(s);
+
+	ASSERT_EQ(s.str(),
+		"Delta 4 5\nGeneration = 0, Population = 3.\n.....\n.....\n.***.\n.....\n\n"
+		"Generation = 1, Population = 3, Changes = 4.\nB 1 2 * 0\nD 2 1 . 0\nD 2 3 . 0\nB 3 2 * 0\n\n");
+}
+
+TEST(DeltaFixture, print_delta2) {
+	istringstream in("----\n-00-\n----\n\n");
+	Life<FredkinCell> l(in, 3, 4);
+
+	ostringstream s;
+	l.print_delta(s);
+	l.evolve_all();
+	l.print_delta(s);
+
+	istringstream d(s.str());
+	DeltaReader r(d);
+	ASSERT_TRUE(r.next());
+	ASSERT_TRUE(r.changes().empty());
+	ASSERT_TRUE(r.next());
+	ASSERT_EQ(r.generation(), 1u);
+
+	int aged = 0;
+	for (const DeltaRecord& c : r.changes())
+		if (c.kind == 'A') {
+			aged++;
+			ASSERT_EQ(c.age, 1);
+			ASSERT_EQ(c.symbol, '1');
+		}
+	ASSERT_EQ(aged, 2);
+	ASSERT_FALSE(r.next());
+}
+
+TEST(DeltaFixture, delta_reader1) {
+	const string text = "-0.*9-7.\n*+-0..0-\n0-*0-0-*\n-.0--8-.\n-0-0**1-\n.1-.-0*-\n\n";
+	const DeltaFormat formats[] = {DELTA_TEXT, DELTA_BINARY};
+
+	for (DeltaFormat f : formats) {
+		istringstream in(text);
+		Life<Cell> l(in, 6, 8);
+
+		stringstream frames;
+		stringstream deltas;
+		for (int i = 0; i < 8; i++) {
+			l.print(frames);
+			l.print_delta(deltas, f);
+			l.evolve_all();
+		}
+
+		DeltaReader r(deltas);
+		string rebuilt;
+		while (r.next())
+			rebuilt += r.frame();
+		ASSERT_EQ(rebuilt, frames.str());
+	}
+}
+
+TEST(DeltaFixture, delta_reader2) {
+	istringstream in1("Delta 2 2\nGeneration = 0, Population = 0.\n..\n..\n\nGeneration = 1, Population = 1, Changes = 1.\nB 5 0 * 0\n\n");
+	DeltaReader r1(in1);
+	ASSERT_TRUE(r1.next());
+	ASSERT_THROW(r1.next(), runtime_error);
+
+	istringstream in2("Generation = 1, Population = 0, Changes = 0.\n\n");
+	DeltaReader r2(in2);
+	ASSERT_THROW(r2.next(), runtime_error);
+}
+
+TEST(DeltaFixture, delta_reader3) {
+	const char rows[] = "..\n.*\n";
+	string keyframe;
+	append_delta_keyframe(keyframe, DELTA_BINARY, 0, 1, 2, 2, rows);
+
+	// a keyframe that claims a 65535 by 65535 board and holds 4 cells
+	string huge = keyframe;
+	const uint32_t side = 65535;
+	memcpy(&huge[12], &side, 4);
+	memcpy(&huge[16], &side, 4);
+	istringstream in1(huge);
+	DeltaReader r1(in1);
+	ASSERT_THROW(r1.next(), runtime_error);
+
+	// changes that claim 2^32 - 1 records and hold none
+	const char header[24] = {'\x89', 'L', 'D', 'C', '\xff', '\xff', '\xff', '\xff'};
+	istringstream in2(keyframe + string(header, sizeof(header)));
+	DeltaReader r2(in2);
+	ASSERT_TRUE(r2.next());
+	ASSERT_THROW(r2.next(), runtime_error);
+
+	istringstream in3("Delta 2 2\nGeneration = 0, Population = 0.\n..\n..\n\nGeneration = 1, Population = 0, Changes = 18446744073709551615.\n\n");
+	DeltaReader r3(in3);
+	ASSERT_TRUE(r3.next());
+	ASSERT_THROW(r3.next(), runtime_error);
+}
+
+TEST(StreamLifeFixture, stream_life_evolve1) {
+	string text;
+	for (int x = 0; x < 23; x++) {
+		for (int y = 0; y < 19; y++)
+			text += ((x * 7 + y * 13 + x * y) % 5 < 2) ? '*' : '.';
+		text += '\n';
+	}
+	text += '\n';
+
+	istringstream in1(text);
+	Life<ConwayCell> l(in1, 23, 19);
+	for (int i = 0; i < 5; i++)
+		l.evolve_all();
+
+	istringstream in2(text);
+	StreamLife<ConwayCell> s(5);
+	ostringstream rows;
+	const unsigned long long population = s.evolve(in2, rows);
+
+	ostringstream frame;
+	frame << "Generation = " << s.get_generation() << ", Population = " << population << ".\n" << rows.str() << "\n";
+	ostringstream expected;
+	l.print(expected);
+	ASSERT_EQ(frame.str(), expected.str());
+	ASSERT_EQ(s.get_height(), 23);
+	ASSERT_EQ(s.get_width(), 19);
+}
+
+TEST(StreamLifeFixture, stream_life_evolve2) {
+	const string text = "-0.*9-7.\n*+-0..0-\n0-*0-0-*\n-.0--8-.\n-0-0**1-\n.1-.-0*-\n\n";
+
+	istringstream in1(text);
+	Life<Cell> l(in1, 6, 8);
+	l.evolve_all();
+	l.evolve_all();
+	ostringstream expected;
+	l.print(expected);
+
+	// the frame print() wrote is a board StreamLife reads, header and all
+	istringstream in2(expected.str());
+	StreamLife<Cell> s(0);
+	ostringstream rows;
+	s.evolve(in2, rows);
+	ASSERT_EQ(s.get_generation(), 2u);
+	ASSERT_EQ("Generation = 2, Population = " + to_string(s.get_population()) + ".\n" + rows.str() + "\n", expected.str());
+}
+
+TEST(StreamLifeFixture, stream_life_evolve3) {
+	char path[] = "/tmp/TestLife.XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	const string text = "..*...\n.*.*..\n..*...\n.***..\n...**.\n\n";
+	{
+		ofstream out(path);
+		out << text;
+	}
+
+	// three passes of two generations, each pass replacing the file
+	StreamLife<ConwayCell> s(2);
+	for (int i = 0; i < 3; i++)
+		s.evolve(string(path), string(path));
+
+	ifstream in(path);
+	const string written((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	remove(path);
+
+	istringstream board(text);
+	Life<ConwayCell> l(board, 5, 6);
+	for (int i = 0; i < 6; i++)
+		l.evolve_all();
+	ostringstream expected;
+	l.print(expected);
+	ASSERT_EQ(written, expected.str());
+}
+
+TEST(StreamLifeFixture, stream_life_evolve4) {
+	// dead fredkin cells keep their age, which only survives inside one pass
+	const string text = "--0---\n-0-0--\n--0---\n------\n---00-\n\n";
+
+	istringstream in1(text);
+	Life<FredkinCell> l(in1, 5, 6);
+	for (int i = 0; i < 6; i++)
+		l.evolve_all();
+	ostringstream expected;
+	l.print(expected);
+
+	istringstream in2(text);
+	StreamLife<FredkinCell> s(6);
+	ostringstream rows;
+	s.evolve(in2, rows);
+	ASSERT_EQ("Generation = 6, Population = " + to_string(s.get_population()) + ".\n" + rows.str() + "\n", expected.str());
+}
+
+TEST(StreamLifeFixture, stream_life_evolve5) {
+	istringstream in("...\n..\n...\n\n");
+	StreamLife<ConwayCell> s(1);
+	ostringstream rows;
+	ASSERT_THROW(s.evolve(in, rows), runtime_error);
+	ASSERT_THROW(s.evolve(string("/nonexistent/board"), string("/nonexistent/next")), runtime_error);
+
+	char path[] = "/tmp/TestLife.XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+	{
+		ofstream out(path);
+		out << "...\n..\n...\n\n";
+	}
+
+	// neither the new board nor its rows are left behind
+	const string to = string(path) + ".next";
+	ASSERT_THROW(s.evolve(string(path), to), runtime_error);
+	remove(path);
+	ASSERT_FALSE(ifstream(to.c_str()).good());
+	ASSERT_FALSE(ifstream((to + ".rows").c_str()).good());
+}
+
+TEST(DistributedLifeFixture, distributed_life_construct1) {
+	istringstream in1("...\n.....\n...\n\n");
+	ASSERT_THROW(DistributedLife<ConwayCell>(in1, 3, 3, 2), runtime_error);
+
+	istringstream in2("...\n...\n...\n\n");
+	ASSERT_THROW(DistributedLife<ConwayCell>(in2, 2, 3, 2), runtime_error);
+
+	istringstream in3("...\n\n");
+	ASSERT_THROW(DistributedLife<ConwayCell>(in3, 2, 3, 2), runtime_error);
+}
+
+TEST(DistributedLifeFixture, distributed_life_failure2) {
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+
+	// a parent that dies without cleaning up after its workers
+	const pid_t parent = fork();
+	ASSERT_GE(parent, 0);
+	if (parent == 0) {
+		istringstream in("...\n***\n...\n...\n\n");
+		DistributedLife<ConwayCell> l(in, 4, 3, 2);
+		const pid_t workers[2] = {l.worker(0), l.worker(1)};
+		if (write(fds[1], workers, sizeof(workers)) != sizeof(workers))
+			_exit(1);
+		raise(SIGKILL);
+	}
+
+	close(fds[1]);
+	pid_t workers[2];
+	ASSERT_EQ(read(fds[0], workers, sizeof(workers)), static_cast<ssize_t>(sizeof(workers)));
+	close(fds[0]);
+	waitpid(parent, nullptr, 0);
+
+	// gone, or a zombie nobody has reaped yet
+	for (pid_t w : workers) {
+		bool dead = false;
+		for (int i = 0; i < 200 && !dead; i++) {
+			ifstream stat("/proc/" + to_string(w) + "/stat");
+			string pid, name, state;
+			dead = !(stat >> pid >> name >> state) || state == "Z";
+			if (!dead)
+				usleep(10000);
+		}
+		ASSERT_TRUE(dead);
+	}
+}